@@ -0,0 +1,88 @@
+#include <memory>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "fiah/engine/BookManager.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/utils/Types.hh"
+#include "fiah/utils/XorBitant.hh"
+
+using namespace fiah;
+
+namespace
+{
+constexpr sz_t NUM_SYMBOLS{1 << 10};
+constexpr sz_t NUM_EVENTS{1 << 18};
+
+LadderOrderbook make_small_book()
+{
+    return LadderOrderbook{256, 512};
+}
+
+/// Many-symbol feed: ~55% adds around a per-symbol mid, 30% cancels and 15%
+/// amends of recent orders.
+const std::vector<OrderEvent>& feed()
+{
+    static const std::vector<OrderEvent> events = [] {
+        std::vector<OrderEvent> out;
+        out.reserve(NUM_EVENTS);
+        std::vector<Id> next_id(NUM_SYMBOLS, 1);
+        XorBitant rng{0xFEED};
+        for (sz_t i = 0; i < NUM_EVENTS; ++i)
+        {
+            const auto symbol = static_cast<SymbolId>(rng() % NUM_SYMBOLS);
+            Id& id = next_id[symbol];
+            const auto action = rng() % 20;
+            const Price price = 1000 + static_cast<Price>(rng() % 32);
+            const Quantity qty = 1 + static_cast<Quantity>(rng() % 50);
+            const Id recent = id > 16 ? id - 1 - rng() % 16 : 1;
+            if (id > 1 && action < 6)
+                out.push_back(OrderEvent::cancel(symbol, recent));
+            else if (id > 1 && action < 9)
+                out.push_back(OrderEvent::modify(symbol, recent, qty, price));
+            else
+                out.push_back(OrderEvent::add(symbol, Order{id++, price, (rng() & 1) != 0, qty}));
+        }
+        return out;
+    }();
+    return events;
+}
+} // namespace
+
+/// Aggregate messages/sec through the manager as shards are added. Shard i is
+/// pinned to core i + 1 when the machine has enough cores; the producer stays
+/// on the calling thread.
+static void BM_BookManager_ShardScaling(benchmark::State &state)
+{
+    const auto num_shards = static_cast<sz_t>(state.range(0));
+    const auto& events = feed();
+
+    std::vector<int> cores;
+    const auto hw = std::thread::hardware_concurrency();
+    for (sz_t i = 0; i < num_shards && i + 1 < hw; ++i)
+        cores.push_back(static_cast<int>(i + 1));
+
+    // A fresh manager per iteration: replaying the feed into books that
+    // already hold its ids would only measure duplicate rejection
+    std::unique_ptr<BookManager<>> manager;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        manager.reset();
+        manager = std::make_unique<BookManager<>>(NUM_SYMBOLS, num_shards, &make_small_book, cores);
+        state.ResumeTiming();
+
+        for (const auto& event : events)
+        {
+            while (!manager->submit(event))
+                _mm_pause();
+        }
+        manager->drain();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * events.size()));
+    state.counters["shards"] = static_cast<double>(num_shards);
+}
+
+BENCHMARK(BM_BookManager_ShardScaling)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,128 @@
+#include <array>
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "fiah/engine/ConflatedDepth.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/utils/Types.hh"
+#include "fiah/utils/XorBitant.hh"
+
+using namespace fiah;
+
+namespace
+{
+constexpr sz_t LEVELS{10};
+
+struct LevelUpdate
+{
+    OrderSide side;
+    u32_t level;
+    DepthLevel value;
+};
+
+using UpdateQueue = SPSCQueue<LevelUpdate, (1 << 16)>;
+
+/// Adds and cancels near the touch, so most events move one of the top levels
+std::vector<Order> make_burst(sz_t n)
+{
+    std::vector<Order> orders;
+    XorBitant rng{11};
+    for (sz_t i = 0; i < n; ++i)
+    {
+        const bool is_buy = (rng() & 1) != 0;
+        const auto offset = 1 + static_cast<Price>(rng() % LEVELS);
+        orders.emplace_back(i + 1, is_buy ? 1000 - offset : 1000 + offset, is_buy, 1);
+    }
+    return orders;
+}
+
+/// The book thread's half of the unconflated hand-off: one queue entry per
+/// level that changed, diffed against its own shadow like ConflatedDepth
+class QueueingPublisher
+{
+  public:
+    explicit QueueingPublisher(UpdateQueue &queue) : m_queue{queue}
+    {
+    }
+
+    void publish(const LadderOrderbook &book)
+    {
+        for (OrderSide side : {OrderSide::BUY, OrderSide::SELL})
+        {
+            auto &shadow = m_shadow[side == OrderSide::BUY ? 0 : 1];
+            std::array<DepthLevel, LEVELS> top{};
+            book.top_levels(side, top);
+            for (u32_t i = 0; i < LEVELS; ++i)
+            {
+                if (top[i].price == shadow[i].price && top[i].qty == shadow[i].qty && top[i].count == shadow[i].count)
+                    continue;
+                shadow[i] = top[i];
+                while (!m_queue.push(LevelUpdate{side, i, top[i]}))
+                    ;
+            }
+        }
+    }
+
+  private:
+    UpdateQueue &m_queue;
+    std::array<std::array<DepthLevel, LEVELS>, 2> m_shadow{};
+};
+} // namespace
+
+/// Book thread applies a burst of `burst` events, publishing after each; the
+/// publisher then catches up once. Items are book events; "delivered" is what
+/// the publisher had to process per burst.
+static void BM_Depth_QueueEveryChange(benchmark::State &state)
+{
+    const auto orders = make_burst(static_cast<sz_t>(state.range(0)));
+    auto queue = std::make_unique<UpdateQueue>();
+    QueueingPublisher publisher{*queue};
+    u64_t delivered = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        LadderOrderbook book{1 << 10, 1 << 16};
+        state.ResumeTiming();
+        for (const Order &order : orders)
+        {
+            book.AddOrder(order, [](const Trade &) {});
+            publisher.publish(book);
+        }
+        LevelUpdate update;
+        while (queue->pop(update))
+        {
+            benchmark::DoNotOptimize(update);
+            ++delivered;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * orders.size()));
+    state.counters["delivered/burst"] = static_cast<double>(delivered) / static_cast<double>(state.iterations());
+}
+
+static void BM_Depth_Conflated(benchmark::State &state)
+{
+    const auto orders = make_burst(static_cast<sz_t>(state.range(0)));
+    auto depth = std::make_unique<ConflatedDepth<LEVELS>>();
+    u64_t delivered = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        LadderOrderbook book{1 << 10, 1 << 16};
+        state.ResumeTiming();
+        for (const Order &order : orders)
+        {
+            book.AddOrder(order, [](const Trade &) {});
+            depth->publish(book);
+        }
+        delivered += depth->drain([](OrderSide, sz_t, const DepthLevel &value) { benchmark::DoNotOptimize(value); });
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * orders.size()));
+    state.counters["delivered/burst"] = static_cast<double>(delivered) / static_cast<double>(state.iterations());
+}
+
+BENCHMARK(BM_Depth_QueueEveryChange)->ArgName("burst")->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(BM_Depth_Conflated)->ArgName("burst")->Arg(16)->Arg(256)->Arg(4096);
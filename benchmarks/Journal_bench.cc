@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "fiah/engine/FeedReplay.hh"
+#include "fiah/engine/Journal.hh"
+#include "fiah/utils/Types.hh"
+
+using namespace fiah;
+
+namespace
+{
+constexpr sz_t SEGMENT{1 << 20};
+
+std::string journal_path()
+{
+    return (std::filesystem::temp_directory_path() / "fiah_journal_bench.wal").string();
+}
+
+std::vector<OrderEvent> make_events(sz_t n)
+{
+    std::vector<OrderEvent> events;
+    events.reserve(n);
+    for (const FeedRecord &record : make_synthetic_feed({.num_events = n}))
+        events.push_back(record.event);
+    return events;
+}
+} // namespace
+
+/// Hot-path cost of journaling one event while the flusher group-commits in
+/// the background
+static void BM_Journal_Append(benchmark::State &state)
+{
+    const std::string path = journal_path();
+    const auto events = make_events(SEGMENT);
+    auto journal = Journal::create(path, SEGMENT);
+    if (!journal)
+    {
+        state.SkipWithError("cannot create journal");
+        return;
+    }
+
+    sz_t i = 0;
+    for (auto _ : state)
+    {
+        if (i == SEGMENT) [[unlikely]]
+        {
+            state.PauseTiming();
+            (void)(*journal)->reset((*journal)->last_seq() + 1);
+            i = 0;
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize((*journal)->append(events[i++]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    journal->reset();
+    std::remove(path.c_str());
+}
+
+/// Baseline for BM_Journal_Append: making every event durable before the
+/// next, i.e. one msync per order
+static void BM_Journal_AppendAndFlush(benchmark::State &state)
+{
+    const std::string path = journal_path();
+    const auto events = make_events(SEGMENT);
+    auto journal = Journal::create(path, SEGMENT);
+    if (!journal)
+    {
+        state.SkipWithError("cannot create journal");
+        return;
+    }
+
+    sz_t i = 0;
+    for (auto _ : state)
+    {
+        if (i == SEGMENT) [[unlikely]]
+        {
+            (void)(*journal)->reset((*journal)->last_seq() + 1);
+            i = 0;
+        }
+        benchmark::DoNotOptimize((*journal)->append(events[i++]));
+        (void)(*journal)->flush();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    journal->reset();
+    std::remove(path.c_str());
+}
+
+BENCHMARK(BM_Journal_Append);
+BENCHMARK(BM_Journal_AppendAndFlush);
@@ -0,0 +1,68 @@
+#include <memory>
+#include <benchmark/benchmark.h>
+
+#include "fiah/memory/PageMapping.hh"
+#include "fiah/structs/MappedSPSCQueue.hh"
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/utils/Types.hh"
+
+using namespace fiah;
+
+namespace
+{
+constexpr u64_t CAPACITY{1 << 20};
+
+struct alignas(64) Msg
+{
+    u64_t seq;
+    u64_t payload[7];
+};
+
+/// One lap: fill the ring, then drain it, touching every slot once
+template <class Q> void lap(Q &queue) noexcept
+{
+    Msg out{};
+    for (u64_t i = 0; i < CAPACITY; ++i)
+        queue.push(Msg{i, {}});
+    while (queue.pop(out))
+        benchmark::DoNotOptimize(out);
+}
+} // namespace
+
+/// First lap over a freshly allocated 64 MiB ring, which is what the hot
+/// path sees right after start-up. The inline queue is default-initialized
+/// with `new`, so its pages are faulted in by the lap itself.
+static void BM_Ring_FirstLap_Inline(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::unique_ptr<SPSCQueue<Msg, CAPACITY>> queue{new SPSCQueue<Msg, CAPACITY>};
+        state.ResumeTiming();
+        lap(*queue);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * CAPACITY));
+}
+
+/// Same lap over a MappedSPSCQueue; args are PageMode and prefault.
+static void BM_Ring_FirstLap_Mapped(benchmark::State &state)
+{
+    const PageConfig config{.pages = static_cast<PageMode>(state.range(0)), .prefault = state.range(1) != 0};
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto queue = MappedSPSCQueue<Msg>::create(CAPACITY, config).value();
+        state.ResumeTiming();
+        lap(*queue);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * CAPACITY));
+}
+
+BENCHMARK(BM_Ring_FirstLap_Inline)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Ring_FirstLap_Mapped)
+    ->ArgNames({"pages", "prefault"})
+    ->Args({static_cast<int64_t>(PageMode::DEFAULT), 0})
+    ->Args({static_cast<int64_t>(PageMode::DEFAULT), 1})
+    ->Args({static_cast<int64_t>(PageMode::TRANSPARENT_HUGE), 1})
+    ->Args({static_cast<int64_t>(PageMode::HUGETLB), 1})
+    ->Unit(benchmark::kMillisecond);
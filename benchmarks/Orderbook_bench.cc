@@ -0,0 +1,555 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "fiah/engine/FeedReplay.hh"
+#include "fiah/engine/OrderEvent.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/structs/SoAOrderbook.hh"
+#include "fiah/utils/Types.hh"
+#include "fiah/utils/XorBitant.hh"
+
+using namespace fiah;
+
+// Global allocation counter behind the allocs/op columns. Replacing operator
+// new here covers the whole fiah_benchmarks binary; the relaxed increment is
+// noise next to the malloc it wraps. The deletes stay out of line so GCC
+// does not pair an inlined free() with operator new and warn.
+namespace
+{
+std::atomic<u64_t> g_allocations{0};
+
+u64_t allocations() noexcept
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void *operator new(std::size_t size, std::align_val_t align)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto al = static_cast<std::size_t>(align);
+    if (void *p = std::aligned_alloc(al, (std::max(size, std::size_t{1}) + al - 1) & ~(al - 1)))
+        return p;
+    throw std::bad_alloc{};
+}
+
+[[gnu::noinline]] void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+constexpr sz_t DEEP_LEVELS{1 << 16};
+constexpr sz_t DEEP_RESTING{1 << 18};
+constexpr Price MID{1'000'000};
+
+struct NullSink
+{
+    void operator()(const Trade& trade) const noexcept
+    {
+        benchmark::DoNotOptimize(trade);
+    }
+};
+
+/// Resting orders in make_deep_book(). The vector books get fewer: every
+/// insert and cancel shifts the side, and at the ladder's depth that shifting
+/// would be all a benchmark measures.
+template <class Book>
+constexpr sz_t deep_resting = std::is_same_v<Book, LadderOrderbook> ? DEEP_RESTING : DEEP_RESTING / 16;
+
+/// Book pre-loaded with passive orders spread over the whole window, so index
+/// slots and levels are mostly cold when an order arrives. Farthest from mid
+/// first, so the vector books only ever append.
+template <class Book> Book make_deep_book()
+{
+    Orders resting;
+    resting.reserve(deep_resting<Book>);
+    XorBitant rng{1};
+    for (Id id = 1; id <= deep_resting<Book>; ++id)
+    {
+        const bool is_buy = (id & 1) != 0;
+        const auto offset = 1 + static_cast<Price>(rng() % (DEEP_LEVELS / 2 - 2));
+        resting.emplace_back(id, is_buy ? MID - offset : MID + offset, is_buy, 10);
+    }
+    std::ranges::stable_sort(resting, std::greater<>{}, [](const Order &o) { return std::abs(o.get_level() - MID); });
+
+    Book book = [] {
+        if constexpr (std::is_same_v<Book, LadderOrderbook>)
+            return LadderOrderbook{DEEP_LEVELS, 2 * DEEP_RESTING};
+        else
+            return Book{};
+    }();
+    for (const Order &order : resting)
+        book.AddOrder(order, NullSink{});
+    return book;
+}
+
+/// Passive orders at random depths; ids start above the resting ones
+Orders make_batch(sz_t n, u64_t seed)
+{
+    Orders batch;
+    batch.reserve(n);
+    XorBitant rng{seed};
+    for (sz_t i = 0; i < n; ++i)
+    {
+        const bool is_buy = (rng() & 1) != 0;
+        const auto offset = 1 + static_cast<Price>(rng() % (DEEP_LEVELS / 2 - 2));
+        batch.emplace_back(DEEP_RESTING + 1 + i, is_buy ? MID - offset : MID + offset, is_buy, 5);
+    }
+    return batch;
+}
+
+// ---------------------------------------------------------------------------
+// Scenario suite: every book type against the same parameterised flows
+// ---------------------------------------------------------------------------
+
+constexpr sz_t ORDERS_PER_LEVEL{4};
+constexpr Quantity RESTING_QTY{10};
+constexpr Id RESTING_ID_BASE{Id{1} << 40}; // clear of the ids flows generate
+constexpr sz_t OPS_PER_ITERATION{1 << 10};
+constexpr sz_t FLOW_EVENTS{1 << 18};
+
+template <class Book> Book make_book(Price depth)
+{
+    if constexpr (std::is_same_v<Book, LadderOrderbook>)
+    {
+        // Room for the resting depth on both sides plus the flow's mid drift
+        const auto levels = std::bit_ceil(std::max(static_cast<sz_t>(depth) * 8, sz_t{1} << 12));
+        return LadderOrderbook{levels, sz_t{1} << 20};
+    }
+    else
+        return Book{};
+}
+
+/// Id of the k-th resting order at `level` ticks from mid on one side. Asks
+/// and bids interleave so the two sides never collide.
+constexpr Id resting_id(Price level, sz_t k, bool is_buy) noexcept
+{
+    return RESTING_ID_BASE + (static_cast<Id>(level) * ORDERS_PER_LEVEL + k) * 2 + (is_buy ? 1 : 0);
+}
+
+/// ORDERS_PER_LEVEL orders of RESTING_QTY on each of `depth` levels per side
+template <class Book> void populate(Book &book, Price depth)
+{
+    for (Price level = 1; level <= depth; ++level)
+    {
+        for (sz_t k = 0; k < ORDERS_PER_LEVEL; ++k)
+        {
+            book.AddOrder(Order{resting_id(level, k, true), MID - level, true, RESTING_QTY}, NullSink{});
+            book.AddOrder(Order{resting_id(level, k, false), MID + level, false, RESTING_QTY}, NullSink{});
+        }
+    }
+}
+
+/// Passive orders at uniform random depth inside the resting range
+Orders make_passive(Price depth, sz_t n, u64_t seed)
+{
+    Orders orders;
+    orders.reserve(n);
+    XorBitant rng{seed};
+    for (sz_t i = 0; i < n; ++i)
+    {
+        const bool is_buy = (rng() & 1) != 0;
+        const Price offset = 1 + static_cast<Price>(rng() % static_cast<u64_t>(depth));
+        orders.emplace_back(i + 1, is_buy ? MID - offset : MID + offset, is_buy, RESTING_QTY);
+    }
+    return orders;
+}
+
+/// Stops the clock and the allocation count together, so setup done under
+/// PauseTiming() does not leak into allocs/op.
+class AllocationMeter
+{
+  public:
+    explicit AllocationMeter(benchmark::State &state) noexcept : m_state{state}, m_mark{allocations()}
+    {
+    }
+
+    void pause()
+    {
+        m_counted += allocations() - m_mark;
+        m_state.PauseTiming();
+    }
+
+    void resume()
+    {
+        m_state.ResumeTiming();
+        m_mark = allocations();
+    }
+
+    /// Publishes items/s, per-op time and allocs/op for `ops_per_iteration`.
+    void report(sz_t ops_per_iteration)
+    {
+        m_counted += allocations() - m_mark;
+        const auto ops = static_cast<double>(m_state.iterations()) * static_cast<double>(ops_per_iteration);
+        m_state.SetItemsProcessed(static_cast<int64_t>(ops));
+        m_state.counters["time/op"] =
+            benchmark::Counter(ops, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+        m_state.counters["allocs/op"] = benchmark::Counter(ops > 0 ? static_cast<double>(m_counted) / ops : 0.0);
+    }
+
+  private:
+    benchmark::State &m_state;
+    u64_t m_mark;
+    u64_t m_counted{0};
+};
+
+void depth_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgName("depth");
+    for (long depth : {64, 1024, 16384})
+        b->Arg(depth);
+}
+} // namespace
+
+/// Passive adds at random depth into a populated book (cancelled off the clock).
+template <class Book> static void BM_Book_Insert(benchmark::State &state)
+{
+    const auto depth = static_cast<Price>(state.range(0));
+    Book book = make_book<Book>(depth);
+    populate(book, depth);
+    const Orders orders = make_passive(depth, OPS_PER_ITERATION, 3);
+
+    AllocationMeter meter{state};
+    for (auto _ : state)
+    {
+        for (const Order &order : orders)
+            book.AddOrder(order, NullSink{});
+        meter.pause();
+        for (const Order &order : orders)
+            book.CancelOrder(order.get_id());
+        meter.resume();
+    }
+    meter.report(orders.size());
+}
+
+/// Cancels of orders at random depth (re-added off the clock).
+template <class Book> static void BM_Book_Cancel(benchmark::State &state)
+{
+    const auto depth = static_cast<Price>(state.range(0));
+    Book book = make_book<Book>(depth);
+    populate(book, depth);
+    const Orders orders = make_passive(depth, OPS_PER_ITERATION, 4);
+
+    AllocationMeter meter{state};
+    for (auto _ : state)
+    {
+        meter.pause();
+        for (const Order &order : orders)
+            book.AddOrder(order, NullSink{});
+        meter.resume();
+        for (const Order &order : orders)
+            book.CancelOrder(order.get_id());
+    }
+    meter.report(orders.size());
+}
+
+/// Aggressive buys that each fill exactly one resting ask at the touch,
+/// walking up the book; the consumed asks are restored off the clock.
+template <class Book> static void BM_Book_Match(benchmark::State &state)
+{
+    const auto depth = static_cast<Price>(state.range(0));
+    Book book = make_book<Book>(depth);
+    populate(book, depth);
+
+    const sz_t n = std::min(OPS_PER_ITERATION, static_cast<sz_t>(depth) * ORDERS_PER_LEVEL);
+    Orders takers, refills;
+    for (sz_t i = 0; i < n; ++i)
+    {
+        const Price level = 1 + static_cast<Price>(i / ORDERS_PER_LEVEL);
+        takers.emplace_back(i + 1, MID + depth, true, RESTING_QTY);
+        refills.emplace_back(resting_id(level, i % ORDERS_PER_LEVEL, false), MID + level, false, RESTING_QTY);
+    }
+
+    AllocationMeter meter{state};
+    for (auto _ : state)
+    {
+        for (const Order &order : takers)
+            book.AddOrder(order, NullSink{});
+        meter.pause();
+        book.AddOrders(refills, NullSink{});
+        meter.resume();
+    }
+    meter.report(n);
+}
+
+/// Aggressive buys that each eat exactly `orders` resting asks, walking up
+/// the book; the consumed asks are restored off the clock after a batch of
+/// sweeps. Items are resting orders consumed, so the per-order cost of a long
+/// sweep is directly comparable across books.
+template <class Book> static void BM_Book_Sweep(benchmark::State &state)
+{
+    constexpr Price depth{1024};
+    const auto orders = static_cast<sz_t>(state.range(0));
+    const sz_t sweeps = std::clamp(static_cast<sz_t>(depth) * ORDERS_PER_LEVEL / orders, sz_t{1}, sz_t{64});
+    Book book = make_book<Book>(depth);
+    populate(book, depth);
+
+    Orders takers, refills;
+    for (sz_t i = 0; i < sweeps * orders; ++i)
+    {
+        const Price level = 1 + static_cast<Price>(i / ORDERS_PER_LEVEL);
+        refills.emplace_back(resting_id(level, i % ORDERS_PER_LEVEL, false), MID + level, false, RESTING_QTY);
+        if ((i + 1) % orders == 0)
+            takers.emplace_back(takers.size() + 1, MID + level, true, static_cast<Quantity>(orders) * RESTING_QTY);
+    }
+
+    AllocationMeter meter{state};
+    for (auto _ : state)
+    {
+        for (const Order &taker : takers)
+            book.AddOrder(taker, NullSink{});
+        meter.pause();
+        book.AddOrders(refills, NullSink{});
+        meter.resume();
+    }
+    meter.report(refills.size());
+}
+
+/// Mixed add/cancel flow from make_synthetic_feed() against a populated book.
+/// Args: depth, cancel %, aggressive % of adds, price skew (0 uniform, 1 near
+/// touch). The book is rebuilt off the clock whenever the flow runs out.
+template <class Book> static void BM_Book_MixedFlow(benchmark::State &state)
+{
+    const auto depth = static_cast<Price>(state.range(0));
+    const auto flow = make_synthetic_feed({.num_events = FLOW_EVENTS,
+                                           .mid = MID,
+                                           .depth = depth,
+                                           .cancel_pct = static_cast<u32_t>(state.range(1)),
+                                           .modify_pct = 0,
+                                           .aggressive_pct = static_cast<u32_t>(state.range(2)),
+                                           .skew = state.range(3) ? PriceSkew::NEAR_TOUCH : PriceSkew::UNIFORM,
+                                           .max_qty = RESTING_QTY});
+
+    auto fresh = [depth] {
+        Book book = make_book<Book>(depth);
+        populate(book, depth);
+        return book;
+    };
+    std::optional<Book> book{fresh()}; // not every book is move-assignable
+    sz_t next = 0;
+
+    AllocationMeter meter{state};
+    for (auto _ : state)
+    {
+        if (next + OPS_PER_ITERATION > flow.size()) [[unlikely]]
+        {
+            meter.pause();
+            book.reset();
+            book.emplace(fresh());
+            next = 0;
+            meter.resume();
+        }
+        for (sz_t end = next + OPS_PER_ITERATION; next < end; ++next)
+            apply_event(*book, flow[next].event, NullSink{});
+    }
+    meter.report(OPS_PER_ITERATION);
+}
+
+void flow_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"depth", "cancel", "aggr", "skew"});
+    for (long depth : {64, 1024})
+        for (long cancel : {20, 45})
+            for (long aggressive : {5, 30})
+                for (long skew : {0, 1})
+                    b->Args({depth, cancel, aggressive, skew});
+}
+
+BENCHMARK_TEMPLATE(BM_Book_Insert, Orderbook)->Apply(depth_args);
+BENCHMARK_TEMPLATE(BM_Book_Insert, LadderOrderbook)->Apply(depth_args);
+BENCHMARK_TEMPLATE(BM_Book_Insert, SoAOrderbook)->Apply(depth_args);
+BENCHMARK_TEMPLATE(BM_Book_Insert, ProbedOrderbook)->Apply(depth_args);
+BENCHMARK_TEMPLATE(BM_Book_Cancel, Orderbook)->Apply(depth_args);
+BENCHMARK_TEMPLATE(BM_Book_Cancel, LadderOrderbook)->Apply(depth_args);
+BENCHMARK_TEMPLATE(BM_Book_Cancel, SoAOrderbook)->Apply(depth_args);
+BENCHMARK_TEMPLATE(BM_Book_Match, Orderbook)->Apply(depth_args);
+BENCHMARK_TEMPLATE(BM_Book_Match, LadderOrderbook)->Apply(depth_args);
+BENCHMARK_TEMPLATE(BM_Book_Match, SoAOrderbook)->Apply(depth_args);
+BENCHMARK_TEMPLATE(BM_Book_Match, ProbedOrderbook)->Apply(depth_args);
+BENCHMARK_TEMPLATE(BM_Book_Sweep, Orderbook)->ArgName("orders")->Arg(8)->Arg(64)->Arg(256);
+BENCHMARK_TEMPLATE(BM_Book_Sweep, LadderOrderbook)->ArgName("orders")->Arg(8)->Arg(64)->Arg(256);
+BENCHMARK_TEMPLATE(BM_Book_Sweep, SoAOrderbook)->ArgName("orders")->Arg(8)->Arg(64)->Arg(256);
+BENCHMARK_TEMPLATE(BM_Book_MixedFlow, Orderbook)->Apply(flow_args);
+BENCHMARK_TEMPLATE(BM_Book_MixedFlow, LadderOrderbook)->Apply(flow_args);
+BENCHMARK_TEMPLATE(BM_Book_MixedFlow, SoAOrderbook)->Apply(flow_args);
+
+/// Baseline for BM_Book_AddOrdersBatch: same batch, one AddOrder per order.
+/// Both variants cancel the batch afterwards to keep the book in steady state.
+template <class Book> static void BM_Book_AddOrderSequential(benchmark::State &state)
+{
+    Book book = make_deep_book<Book>();
+    const Orders batch = make_batch(static_cast<sz_t>(state.range(0)), 2);
+
+    for (auto _ : state)
+    {
+        for (const Order& order : batch)
+            book.AddOrder(order, NullSink{});
+        for (const Order& order : batch)
+            book.CancelOrder(order.get_id());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch.size()));
+}
+
+template <class Book> static void BM_Book_AddOrdersBatch(benchmark::State &state)
+{
+    Book book = make_deep_book<Book>();
+    const Orders batch = make_batch(static_cast<sz_t>(state.range(0)), 2);
+
+    for (auto _ : state)
+    {
+        book.AddOrders(batch, NullSink{});
+        for (const Order& order : batch)
+            book.CancelOrder(order.get_id());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch.size()));
+}
+
+BENCHMARK_TEMPLATE(BM_Book_AddOrderSequential, Orderbook)->Arg(32)->Arg(256);
+BENCHMARK_TEMPLATE(BM_Book_AddOrdersBatch, Orderbook)->Arg(32)->Arg(256);
+BENCHMARK_TEMPLATE(BM_Book_AddOrderSequential, LadderOrderbook)->Arg(32)->Arg(256);
+BENCHMARK_TEMPLATE(BM_Book_AddOrdersBatch, LadderOrderbook)->Arg(32)->Arg(256);
+BENCHMARK_TEMPLATE(BM_Book_AddOrderSequential, SoAOrderbook)->Arg(32)->Arg(256);
+BENCHMARK_TEMPLATE(BM_Book_AddOrdersBatch, SoAOrderbook)->Arg(32)->Arg(256);
+
+// ---------------------------------------------------------------------------
+// Field width: the default book against CompactOrderbook (16-byte orders,
+// inline fixed-capacity sides) on the same passive and aggressive flow
+// ---------------------------------------------------------------------------
+
+namespace
+{
+constexpr sz_t COMPACT_DEPTH{4096};
+using CompactBook = CompactOrderbook<1, COMPACT_DEPTH>;
+
+struct AnyTradeSink
+{
+    template <class T> void operator()(const T &trade) const noexcept
+    {
+        benchmark::DoNotOptimize(trade);
+    }
+};
+
+template <class Book> using OrderOf = typename Book::order_type;
+
+template <class Book> OrderOf<Book> make_order(sz_t id, Price level, bool is_buy, Quantity qty)
+{
+    using O = OrderOf<Book>;
+    return O{static_cast<typename O::id_type>(id), static_cast<typename O::price_type>(level), is_buy,
+             static_cast<typename O::quantity_type>(qty)};
+}
+
+/// ORDERS_PER_LEVEL orders on each of `depth` levels per side, ids from 1
+template <class Book> std::unique_ptr<Book> make_populated(Price depth)
+{
+    auto book = std::make_unique<Book>();
+    sz_t id = 0;
+    for (Price level = 1; level <= depth; ++level)
+    {
+        for (sz_t k = 0; k < ORDERS_PER_LEVEL; ++k)
+        {
+            book->AddOrder(make_order<Book>(++id, MID - level, true, RESTING_QTY), AnyTradeSink{});
+            book->AddOrder(make_order<Book>(++id, MID + level, false, RESTING_QTY), AnyTradeSink{});
+        }
+    }
+    return book;
+}
+
+void width_args(benchmark::internal::Benchmark *b)
+{
+    b->ArgName("depth");
+    for (long depth : {64, 256})
+        b->Arg(depth);
+}
+} // namespace
+
+/// Passive adds at random depth, cancelled off the clock.
+template <class Book> static void BM_Width_Insert(benchmark::State &state)
+{
+    const auto depth = static_cast<Price>(state.range(0));
+    auto book = make_populated<Book>(depth);
+    std::vector<OrderOf<Book>> orders;
+    XorBitant rng{3};
+    for (sz_t i = 0; i < OPS_PER_ITERATION; ++i)
+    {
+        const bool is_buy = (rng() & 1) != 0;
+        const Price offset = 1 + static_cast<Price>(rng() % static_cast<u64_t>(depth));
+        orders.push_back(make_order<Book>(COMPACT_DEPTH * 4 + i, is_buy ? MID - offset : MID + offset, is_buy,
+                                          RESTING_QTY));
+    }
+
+    for (auto _ : state)
+    {
+        for (const auto &order : orders)
+            book->AddOrder(order, AnyTradeSink{});
+        state.PauseTiming();
+        for (const auto &order : orders)
+            book->CancelOrder(order.get_id());
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * orders.size()));
+}
+
+/// Buys that each fill one resting ask at the touch, refilled off the clock.
+template <class Book> static void BM_Width_Match(benchmark::State &state)
+{
+    const auto depth = static_cast<Price>(state.range(0));
+    auto book = make_populated<Book>(depth);
+    const sz_t n = static_cast<sz_t>(depth) * ORDERS_PER_LEVEL;
+    std::vector<OrderOf<Book>> takers, refills;
+    for (sz_t i = 0; i < n; ++i)
+    {
+        const Price level = 1 + static_cast<Price>(i / ORDERS_PER_LEVEL);
+        takers.push_back(make_order<Book>(COMPACT_DEPTH * 4 + i, MID + depth, true, RESTING_QTY));
+        refills.push_back(make_order<Book>(2 * i + 2, MID + level, false, RESTING_QTY));
+    }
+
+    for (auto _ : state)
+    {
+        for (const auto &order : takers)
+            book->AddOrder(order, AnyTradeSink{});
+        state.PauseTiming();
+        book->AddOrders(refills, AnyTradeSink{});
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+BENCHMARK_TEMPLATE(BM_Width_Insert, Orderbook)->Apply(width_args);
+BENCHMARK_TEMPLATE(BM_Width_Insert, CompactBook)->Apply(width_args);
+BENCHMARK_TEMPLATE(BM_Width_Match, Orderbook)->Apply(width_args);
+BENCHMARK_TEMPLATE(BM_Width_Match, CompactBook)->Apply(width_args);
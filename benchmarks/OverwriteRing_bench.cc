@@ -0,0 +1,81 @@
+#include <x86intrin.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <benchmark/benchmark.h>
+
+#include "fiah/structs/OverwriteRing.hh"
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/utils/Types.hh"
+
+using namespace fiah;
+
+namespace
+{
+constexpr u64_t CAPACITY{1024};
+
+struct Quote
+{
+    u64_t seq;
+    i64_t bid, ask;
+};
+} // namespace
+
+/// Producer cost with nobody reading: the ring laps itself on every push, and
+/// push() is the same straight-line store sequence as with a reader.
+static void BM_Overwrite_PushUnread(benchmark::State &state)
+{
+    auto ring = std::make_unique<OverwriteRing<Quote, CAPACITY>>();
+    u64_t seq = 0;
+    for (auto _ : state)
+    {
+        ring->push(Quote{seq, 100, 101});
+        ++seq;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+/// A consumer that does `work` pause instructions per entry and falls behind.
+/// The bounded queue's producer stalls to its pace; the ring's producer keeps
+/// its own and the consumer reports what it skipped.
+template <bool LOSSY> static void BM_Overwrite_SlowConsumer(benchmark::State &state)
+{
+    const auto work = static_cast<u32_t>(state.range(0));
+    using Ring = std::conditional_t<LOSSY, OverwriteRing<Quote, CAPACITY>, SPSCQueue<Quote, CAPACITY>>;
+    auto ring = std::make_unique<Ring>();
+    std::atomic<u64_t> consumed{0};
+    std::jthread consumer{[&](std::stop_token st) {
+        Quote out{};
+        while (!st.stop_requested())
+        {
+            if (!ring->pop(out))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            for (u32_t i = 0; i < work; ++i)
+                _mm_pause();
+            consumed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }};
+
+    u64_t seq = 0;
+    for (auto _ : state)
+    {
+        const Quote quote{seq++, 100, 101};
+        if constexpr (LOSSY)
+            ring->push(quote);
+        else
+            while (!ring->push(quote))
+                std::this_thread::yield();
+    }
+    consumer.request_stop();
+    consumer.join();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.counters["consumed"] = static_cast<double>(consumed.load());
+}
+
+BENCHMARK(BM_Overwrite_PushUnread);
+BENCHMARK_TEMPLATE(BM_Overwrite_SlowConsumer, false)->ArgName("work")->Arg(16)->Arg(128)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Overwrite_SlowConsumer, true)->ArgName("work")->Arg(16)->Arg(128)->UseRealTime();
@@ -0,0 +1,156 @@
+#include <unordered_map>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "fiah/engine/RiskGate.hh"
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/utils/Types.hh"
+#include "fiah/utils/XorBitant.hh"
+
+using namespace fiah;
+
+namespace
+{
+constexpr sz_t NUM_ORDERS{1 << 12};
+constexpr RiskLimits LIMITS{.max_order_qty = 1'000,
+                            .max_order_notional = 1'000'000'000,
+                            .max_position = 1'000'000'000,
+                            .max_orders_per_window = 1'000'000'000,
+                            .rate_window_ns = 1'000'000'000};
+
+struct Request
+{
+    AccountId account;
+    Order order;
+};
+
+std::vector<Request> make_requests(sz_t num_accounts)
+{
+    std::vector<Request> requests;
+    requests.reserve(NUM_ORDERS);
+    XorBitant rng{7};
+    for (sz_t i = 0; i < NUM_ORDERS; ++i)
+    {
+        const bool is_buy = (rng() & 1) != 0;
+        const auto account = static_cast<AccountId>(rng() % num_accounts);
+        requests.push_back({account, Order{i + 1, 1000 + static_cast<Price>(rng() % 64), is_buy,
+                                           1 + static_cast<Quantity>(rng() % 100)}});
+    }
+    return requests;
+}
+
+/// The shape RiskGate replaces: one hash map per concern, keyed by account
+class MapRisk
+{
+  public:
+    void set_limits(u32_t account, const RiskLimits &limits)
+    {
+        m_limits[account] = limits;
+        m_position[account] = 0;
+        m_window[account] = {0, 0};
+    }
+
+    bool check(u32_t account, const Order &order, u64_t now_ns)
+    {
+        auto limits = m_limits.find(account);
+        if (limits == m_limits.end())
+            return false;
+        const i64_t qty = order.get_qty();
+        if (qty <= 0 || qty > limits->second.max_order_qty)
+            return false;
+        if (qty * order.get_level() > limits->second.max_order_notional)
+            return false;
+        if (std::abs(m_position.at(account) + (order.is_buy() ? qty : -qty)) > limits->second.max_position)
+            return false;
+        auto &[start, count] = m_window.at(account);
+        if (now_ns - start >= limits->second.rate_window_ns)
+        {
+            start = now_ns;
+            count = 0;
+        }
+        if (count >= limits->second.max_orders_per_window)
+            return false;
+        ++count;
+        return true;
+    }
+
+  private:
+    std::unordered_map<u32_t, RiskLimits> m_limits;
+    std::unordered_map<u32_t, i64_t> m_position;
+    std::unordered_map<u32_t, std::pair<u64_t, u32_t>> m_window;
+};
+} // namespace
+
+/// One check per order over `accounts` accounts picked at random.
+static void BM_Risk_Gate(benchmark::State &state)
+{
+    const auto num_accounts = static_cast<sz_t>(state.range(0));
+    RiskGate gate{num_accounts};
+    for (sz_t a = 0; a < num_accounts; ++a)
+        gate.set_limits(static_cast<AccountId>(a), LIMITS);
+    const auto requests = make_requests(num_accounts);
+
+    u64_t now = 0;
+    for (auto _ : state)
+    {
+        for (const Request &request : requests)
+            benchmark::DoNotOptimize(gate.check(request.account, request.order, ++now));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * requests.size()));
+}
+
+static void BM_Risk_Maps(benchmark::State &state)
+{
+    const auto num_accounts = static_cast<sz_t>(state.range(0));
+    MapRisk risk;
+    for (sz_t a = 0; a < num_accounts; ++a)
+        risk.set_limits(static_cast<u32_t>(a), LIMITS);
+    const auto requests = make_requests(num_accounts);
+
+    u64_t now = 0;
+    for (auto _ : state)
+    {
+        for (const Request &request : requests)
+            benchmark::DoNotOptimize(risk.check(request.account, request.order, ++now));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * requests.size()));
+}
+
+/// Passive adds with and without the gate in front; cancelled off the clock.
+template <bool GATED> static void BM_Risk_AddOrder(benchmark::State &state)
+{
+    constexpr sz_t NUM_ACCOUNTS{256};
+    RiskGate gate{NUM_ACCOUNTS};
+    for (sz_t a = 0; a < NUM_ACCOUNTS; ++a)
+        gate.set_limits(static_cast<AccountId>(a), LIMITS);
+    auto requests = make_requests(NUM_ACCOUNTS);
+    // Bids below, asks above: nothing crosses
+    for (Request &request : requests)
+        request.order = Order{request.order.get_id(),
+                              request.order.get_level() + (request.order.is_buy() ? 0 : 100),
+                              request.order.is_buy(), request.order.get_qty()};
+    Orderbook book;
+    auto sink = [](const Trade &trade) { benchmark::DoNotOptimize(trade); };
+
+    u64_t now = 0;
+    for (auto _ : state)
+    {
+        for (const Request &request : requests)
+        {
+            if constexpr (GATED)
+                benchmark::DoNotOptimize(gate.add_order(book, request.account, request.order, ++now, sink));
+            else
+                book.AddOrder(request.order, sink);
+        }
+        state.PauseTiming();
+        for (const Request &request : requests)
+            book.CancelOrder(request.order.get_id());
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * requests.size()));
+}
+
+BENCHMARK(BM_Risk_Gate)->ArgName("accounts")->Arg(16)->Arg(1024)->Arg(65535);
+BENCHMARK(BM_Risk_Maps)->ArgName("accounts")->Arg(16)->Arg(1024)->Arg(65535);
+BENCHMARK_TEMPLATE(BM_Risk_AddOrder, false);
+BENCHMARK_TEMPLATE(BM_Risk_AddOrder, true);
@@ -0,0 +1,383 @@
+#include <x86intrin.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/thread/Affinity.hh"
+#include "fiah/utils/Probe.hh"
+#include "fiah/utils/Types.hh"
+
+using namespace fiah;
+
+namespace
+{
+constexpr u64_t CAPACITY{1024};
+constexpr sz_t BATCH{1 << 14};
+
+struct Msg
+{
+    u64_t seq;
+    u64_t tsc;
+};
+
+/// SPSCQueue as it was before the cached indices: both sides load the other's
+/// index on every call. Kept here as the baseline.
+template <class T, u64_t N> class UncachedSPSC
+{
+  public:
+    bool push(const T &value) noexcept
+    {
+        const u64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == N)
+            return false;
+        m_slots[head & (N - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &out) noexcept
+    {
+        const u64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_head.load(std::memory_order_acquire) == tail)
+            return false;
+        out = m_slots[tail & (N - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    alignas(cacheline_t::value) std::atomic<u64_t> m_head{0};
+    alignas(cacheline_t::value) std::atomic<u64_t> m_tail{0};
+    alignas(cacheline_t::value) T m_slots[N];
+};
+
+/// Same shape as SPSCLogger's Record: a formatted line plus a header
+struct alignas(64) Record
+{
+    char text[512];
+    u64_t seq;
+    u32_t len;
+};
+
+using Cached = SPSCQueue<Msg, CAPACITY>;
+using Uncached = UncachedSPSC<Msg, CAPACITY>;
+
+/// Spins with pause, and yields once it has spun for a while, so the
+/// benchmarks still finish on a box with fewer cores than threads.
+class Backoff
+{
+  public:
+    void wait() noexcept
+    {
+        if (++m_spins < 256)
+            _mm_pause();
+        else
+            std::this_thread::yield();
+    }
+
+    void reset() noexcept
+    {
+        m_spins = 0;
+    }
+
+  private:
+    u32_t m_spins{0};
+};
+
+template <class Q> void push_blocking(Q &queue, const Msg &msg) noexcept
+{
+    Backoff backoff;
+    while (!queue.push(msg))
+        backoff.wait();
+}
+
+template <class Q> Msg pop_blocking(Q &queue) noexcept
+{
+    Backoff backoff;
+    Msg msg;
+    while (!queue.pop(msg))
+        backoff.wait();
+    return msg;
+}
+
+/// Producer on core 0 and consumer on core 1, when there are two cores
+void pin(int core) noexcept
+{
+    if (std::thread::hardware_concurrency() >= 2)
+        pin_this_thread(core);
+}
+} // namespace
+
+/// Unpaced one-way transfer; items/s is the sustained message rate.
+template <class Q> static void BM_SPSC_Throughput(benchmark::State &state)
+{
+    auto queue = std::make_unique<Q>();
+    std::atomic<u64_t> received{0};
+    std::jthread consumer{[&](std::stop_token st) {
+        pin(1);
+        Backoff backoff;
+        Msg msg;
+        u64_t count = 0;
+        while (!st.stop_requested())
+        {
+            if (queue->pop(msg))
+            {
+                benchmark::DoNotOptimize(msg);
+                received.store(++count, std::memory_order_release);
+                backoff.reset();
+            }
+            else
+                backoff.wait();
+        }
+    }};
+    pin(0);
+
+    u64_t sent = 0;
+    for (auto _ : state)
+    {
+        for (sz_t i = 0; i < BATCH; ++i)
+            push_blocking(*queue, Msg{sent++, 0});
+        Backoff backoff;
+        while (received.load(std::memory_order_acquire) != sent)
+            backoff.wait();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+}
+
+/// Ping-pong through a pair of queues; time per iteration is one round trip.
+template <class Q> static void BM_SPSC_RoundTrip(benchmark::State &state)
+{
+    auto ping = std::make_unique<Q>();
+    auto pong = std::make_unique<Q>();
+    std::jthread echo{[&](std::stop_token st) {
+        pin(1);
+        Backoff backoff;
+        Msg msg;
+        while (!st.stop_requested())
+        {
+            if (ping->pop(msg))
+            {
+                push_blocking(*pong, msg);
+                backoff.reset();
+            }
+            else
+                backoff.wait();
+        }
+    }};
+    pin(0);
+
+    u64_t seq = 0;
+    for (auto _ : state)
+    {
+        push_blocking(*ping, Msg{seq++, 0});
+        benchmark::DoNotOptimize(pop_blocking(*pong));
+    }
+}
+
+/// Producer paced at `rate` msg/s stamps each message with the TSC; the
+/// consumer histograms the one-way delay. Reports p50/p99 in ns.
+template <class Q> static void BM_SPSC_PacedLatency(benchmark::State &state)
+{
+    const double ns_per_cycle = calibrate_tsc();
+    const auto rate = static_cast<double>(state.range(0));
+    const auto gap = static_cast<u64_t>(1e9 / rate / ns_per_cycle);
+
+    auto queue = std::make_unique<Q>();
+    LatencyHistogram delay;
+    std::atomic<u64_t> received{0};
+    std::jthread consumer{[&](std::stop_token st) {
+        pin(1);
+        Backoff backoff;
+        Msg msg;
+        u64_t count = 0;
+        while (!st.stop_requested())
+        {
+            if (queue->pop(msg))
+            {
+                delay.record(__rdtsc() - msg.tsc);
+                received.store(++count, std::memory_order_release);
+                backoff.reset();
+            }
+            else
+                backoff.wait();
+        }
+    }};
+    pin(0);
+
+    u64_t sent = 0;
+    for (auto _ : state)
+    {
+        u64_t due = __rdtsc();
+        for (sz_t i = 0; i < BATCH; ++i)
+        {
+            due += gap;
+            while (__rdtsc() < due)
+                _mm_pause();
+            push_blocking(*queue, Msg{sent++, __rdtsc()});
+        }
+        Backoff backoff;
+        while (received.load(std::memory_order_acquire) != sent)
+            backoff.wait();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+    state.counters["p50_ns"] = static_cast<double>(delay.percentile(0.50)) * ns_per_cycle;
+    state.counters["p99_ns"] = static_cast<double>(delay.percentile(0.99)) * ns_per_cycle;
+}
+
+/// Producer sends bursts of `burst` messages, as a feed handler does per
+/// datagram; BULK moves each burst with push_bulk()/pop_bulk() instead of one
+/// push()/pop() per message.
+template <bool BULK> static void BM_SPSC_Burst(benchmark::State &state)
+{
+    const auto burst = static_cast<sz_t>(state.range(0));
+    auto queue = std::make_unique<Cached>();
+    std::atomic<u64_t> received{0};
+    std::jthread consumer{[&](std::stop_token st) {
+        pin(1);
+        Backoff backoff;
+        Msg out[64];
+        u64_t count = 0;
+        while (!st.stop_requested())
+        {
+            sz_t n = 0;
+            if constexpr (BULK)
+                n = queue->pop_bulk(out);
+            else
+                while (n < std::size(out) && queue->pop(out[n]))
+                    ++n;
+            if (n == 0)
+            {
+                backoff.wait();
+                continue;
+            }
+            benchmark::DoNotOptimize(out);
+            received.store(count += n, std::memory_order_release);
+            backoff.reset();
+        }
+    }};
+    pin(0);
+
+    std::vector<Msg> msgs(burst);
+    u64_t sent = 0;
+    for (auto _ : state)
+    {
+        for (sz_t b = 0; b < BATCH / burst; ++b)
+        {
+            for (Msg &msg : msgs)
+                msg.seq = sent++;
+            if constexpr (BULK)
+            {
+                Backoff backoff;
+                for (std::span<const Msg> rest{msgs}; !rest.empty();)
+                {
+                    const sz_t n = queue->push_bulk(rest);
+                    if (n == 0)
+                        backoff.wait();
+                    rest = rest.subspan(n);
+                }
+            }
+            else
+                for (const Msg &msg : msgs)
+                    push_blocking(*queue, msg);
+        }
+        Backoff backoff;
+        while (received.load(std::memory_order_acquire) != sent)
+            backoff.wait();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+}
+
+/// Large elements: building a Record on the stack and pushing a copy, then
+/// popping another copy out, against formatting into the slot with
+/// try_reserve()/commit() and reading it in place with front()/release().
+template <bool IN_PLACE> static void BM_SPSC_LargeRecord(benchmark::State &state)
+{
+    auto queue = std::make_unique<SPSCQueue<Record, CAPACITY>>();
+    std::atomic<u64_t> received{0};
+    std::jthread consumer{[&](std::stop_token st) {
+        pin(1);
+        Backoff backoff;
+        u64_t count = 0;
+        Record rec;
+        while (!st.stop_requested())
+        {
+            u64_t checksum = 0;
+            if constexpr (IN_PLACE)
+            {
+                const Record *front = queue->front();
+                if (!front)
+                {
+                    backoff.wait();
+                    continue;
+                }
+                checksum = front->seq + static_cast<u8_t>(front->text[front->len - 1]);
+                queue->release();
+            }
+            else
+            {
+                if (!queue->pop(rec))
+                {
+                    backoff.wait();
+                    continue;
+                }
+                checksum = rec.seq + static_cast<u8_t>(rec.text[rec.len - 1]);
+            }
+            benchmark::DoNotOptimize(checksum);
+            received.store(++count, std::memory_order_release);
+            backoff.reset();
+        }
+    }};
+    pin(0);
+
+    auto fill = [](Record &rec, u64_t seq) noexcept {
+        rec.seq = seq;
+        const int n = std::snprintf(rec.text, sizeof(rec.text), "order %lu filled %d @ %d", seq, 100, 4200);
+        rec.len = static_cast<u32_t>(n);
+    };
+    u64_t sent = 0;
+    for (auto _ : state)
+    {
+        for (sz_t i = 0; i < BATCH; ++i, ++sent)
+        {
+            Backoff backoff;
+            if constexpr (IN_PLACE)
+            {
+                Record *slot;
+                while (!(slot = queue->try_reserve()))
+                    backoff.wait();
+                fill(*slot, sent);
+                queue->commit();
+            }
+            else
+            {
+                Record rec;
+                fill(rec, sent);
+                while (!queue->push(rec))
+                    backoff.wait();
+            }
+        }
+        Backoff backoff;
+        while (received.load(std::memory_order_acquire) != sent)
+            backoff.wait();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+}
+
+BENCHMARK_TEMPLATE(BM_SPSC_Throughput, Uncached)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_Throughput, Cached)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_RoundTrip, Uncached)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_RoundTrip, Cached)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_PacedLatency, Uncached)->ArgName("rate")->Arg(1'000'000)->Arg(10'000'000)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_PacedLatency, Cached)->ArgName("rate")->Arg(1'000'000)->Arg(10'000'000)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_Burst, false)->ArgName("burst")->Arg(8)->Arg(32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_Burst, true)->ArgName("burst")->Arg(8)->Arg(32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_LargeRecord, false)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_LargeRecord, true)->UseRealTime();
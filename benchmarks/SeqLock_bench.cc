@@ -0,0 +1,103 @@
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <benchmark/benchmark.h>
+
+#include "fiah/engine/Bbo.hh"
+#include "fiah/structs/SeqLock.hh"
+#include "fiah/utils/Types.hh"
+
+using namespace fiah;
+
+namespace
+{
+/// Republishes a moving BBO as fast as it can until destroyed
+template <class Publish> class BackgroundWriter
+{
+  public:
+    explicit BackgroundWriter(Publish publish)
+        : m_thread{[publish](std::stop_token st) mutable {
+              Price px = 100;
+              while (!st.stop_requested())
+              {
+                  ++px;
+                  publish(Bbo{px, 10, 1, px + 1, 10, 1});
+              }
+          }}
+    {
+    }
+
+  private:
+    std::jthread m_thread;
+};
+
+struct MutexBbo
+{
+    mutable std::mutex mutex;
+    Bbo bbo{};
+
+    void store(const Bbo &value)
+    {
+        std::scoped_lock lock{mutex};
+        bbo = value;
+    }
+
+    Bbo load() const
+    {
+        std::scoped_lock lock{mutex};
+        return bbo;
+    }
+};
+} // namespace
+
+static void BM_SeqLock_ReadIdle(benchmark::State &state)
+{
+    SeqLock<Bbo> lock{Bbo{100, 10, 1, 101, 10, 1}};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(lock.load());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+/// Reader on this thread, writer storing back to back on another core
+static void BM_SeqLock_ReadWhileWriting(benchmark::State &state)
+{
+    SeqLock<Bbo> lock;
+    BackgroundWriter writer{[&lock](const Bbo &bbo) { lock.store(bbo); }};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(lock.load());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+/// Baseline for BM_SeqLock_ReadWhileWriting
+static void BM_Mutex_ReadWhileWriting(benchmark::State &state)
+{
+    MutexBbo guarded;
+    BackgroundWriter writer{[&guarded](const Bbo &bbo) { guarded.store(bbo); }};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(guarded.load());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+/// Several readers polling an idle BBO: nothing is written, so the line
+/// stays shared in every reader's cache
+static void BM_SeqLock_ManyReaders(benchmark::State &state)
+{
+    static SeqLock<Bbo> lock{Bbo{100, 10, 1, 101, 10, 1}};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(lock.load());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+static void BM_Mutex_ManyReaders(benchmark::State &state)
+{
+    static MutexBbo guarded;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(guarded.load());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_SeqLock_ReadIdle);
+BENCHMARK(BM_SeqLock_ReadWhileWriting)->UseRealTime();
+BENCHMARK(BM_Mutex_ReadWhileWriting)->UseRealTime();
+BENCHMARK(BM_SeqLock_ManyReaders)->Threads(1)->Threads(2)->Threads(4)->UseRealTime();
+BENCHMARK(BM_Mutex_ManyReaders)->Threads(1)->Threads(2)->Threads(4)->UseRealTime();
@@ -0,0 +1,108 @@
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/utils/Types.hh"
+#include "fiah/utils/XorBitant.hh"
+
+using namespace fiah;
+
+namespace
+{
+constexpr Price MID{1'000'000};
+constexpr sz_t LEVELS{1 << 16};
+
+/// Passive orders on both sides, spread over most of the ladder window
+Orders make_resting(sz_t n)
+{
+    Orders orders;
+    orders.reserve(n);
+    XorBitant rng{11};
+    for (sz_t i = 0; i < n; ++i)
+    {
+        const bool is_buy = (i & 1) != 0;
+        const auto offset = 1 + static_cast<Price>(rng() % (LEVELS / 2 - 2));
+        orders.emplace_back(i + 1, is_buy ? MID - offset : MID + offset, is_buy, 10);
+    }
+    return orders;
+}
+
+std::string image_path()
+{
+    return (std::filesystem::temp_directory_path() / "fiah_snapshot_bench.img").string();
+}
+} // namespace
+
+/// Warm restart from a snapshot image of `n` resting orders
+static void BM_Ladder_RestoreSnapshot(benchmark::State &state)
+{
+    const auto n = static_cast<sz_t>(state.range(0));
+    const std::string path = image_path();
+    {
+        LadderOrderbook book{LEVELS, n};
+        for (const Order &order : make_resting(n))
+            book.AddOrder(order, [](const Trade &) {});
+        if (!book.save_snapshot(path))
+        {
+            state.SkipWithError("cannot write snapshot");
+            return;
+        }
+    }
+
+    for (auto _ : state)
+    {
+        auto restored = LadderOrderbook::restore_snapshot(path);
+        benchmark::DoNotOptimize(restored);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+    std::remove(path.c_str());
+}
+
+/// Baseline for BM_Ladder_RestoreSnapshot: rebuilding the same book by
+/// re-adding every resting order
+static void BM_Ladder_RebuildByReplay(benchmark::State &state)
+{
+    const auto n = static_cast<sz_t>(state.range(0));
+    const Orders orders = make_resting(n);
+
+    for (auto _ : state)
+    {
+        LadderOrderbook book{LEVELS, n};
+        for (const Order &order : orders)
+            book.AddOrder(order, [](const Trade &) {});
+        benchmark::DoNotOptimize(book);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+static void BM_Orderbook_RestoreSnapshot(benchmark::State &state)
+{
+    const auto n = static_cast<sz_t>(state.range(0));
+    const std::string path = image_path();
+    {
+        Orderbook book;
+        for (const Order &order : make_resting(n))
+            book.AddOrder(order, [](const Trade &) {});
+        if (!book.save_snapshot(path))
+        {
+            state.SkipWithError("cannot write snapshot");
+            return;
+        }
+    }
+
+    for (auto _ : state)
+    {
+        auto restored = Orderbook::restore_snapshot(path);
+        benchmark::DoNotOptimize(restored);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+    std::remove(path.c_str());
+}
+
+BENCHMARK(BM_Ladder_RestoreSnapshot)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Ladder_RebuildByReplay)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Orderbook_RestoreSnapshot)->Arg(1 << 16)->Unit(benchmark::kMillisecond);
@@ -11,6 +11,8 @@
 #include "fiah/utils/Timer.hh"
 #include "fiah/utils/TimeStamp.hh"
 #include "fiah/utils/TSCTimer.hh"
+#include "fiah/utils/CacheLine.hh"
+#include "fiah/utils/Probe.hh"
 #include "fiah/utils/Logger.hh"
 #include "fiah/utils/SimpleLogger.hh"
 #include "fiah/utils/TomlParser.hh"
@@ -24,6 +26,8 @@
 #include "fiah/io/TcpServer.hh"
 #include "fiah/io/Udp.hh"
 #include "fiah/io/Config.hh"
+#include "fiah/io/MappedFile.hh"
+#include "fiah/io/BinaryImage.hh"
 
 // Math
 #include "fiah/math/AutoDiff.hpp"
@@ -32,15 +36,35 @@
 
 // Structs
 #include "fiah/structs/Orderbook.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/SoAOrderbook.hh"
+#include "fiah/structs/SeqLock.hh"
 #include "fiah/structs/SPSCQueue.hh"
 #include "fiah/structs/ThreadSafeQueue.hh"
 #include "fiah/structs/Vector.hh"
+#include "fiah/structs/FlatIdMap.hh"
+#include "fiah/structs/InplaceVector.hh"
 #include "fiah/structs/MPSCQueue.hh"
+#include "fiah/structs/OverwriteRing.hh"
+#include "fiah/structs/MappedSPSCQueue.hh"
 
 // Threads
 #include "fiah/thread/SpinMutex.hpp"
 #include "fiah/thread/ThreadPool.hpp"
+#include "fiah/thread/Affinity.hh"
+
+// Engine
+#include "fiah/engine/OrderEvent.hh"
+#include "fiah/engine/BookManager.hh"
+#include "fiah/engine/FeedReplay.hh"
+#include "fiah/engine/Journal.hh"
+#include "fiah/engine/Bbo.hh"
+#include "fiah/engine/ConflatedDepth.hh"
+#include "fiah/engine/Pipeline.hh"
+#include "fiah/engine/RiskGate.hh"
 
 // Memory 
 #include "fiah/memory/BumpAllocator.hh"
-#include "fiah/memory/BumpArena.hh"
\ No newline at end of file
+#include "fiah/memory/BumpArena.hh"
+#include "fiah/memory/ObjectPool.hh"
+#include "fiah/memory/PageMapping.hh"
\ No newline at end of file
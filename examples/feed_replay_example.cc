@@ -0,0 +1,105 @@
+// C++ Includes
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// FastInAHurry Includes
+#include "fiah/engine/FeedReplay.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/Orderbook.hh"
+
+namespace fiah
+{
+static int Usage()
+{
+    std::cerr << "usage:\n"
+                 "  feed_replay_example gen <file> [events] [symbols] [seed]\n"
+                 "  feed_replay_example replay <file> [--paced] [--speed X] [--vector]\n";
+    return 1;
+}
+
+static int Generate(const std::string &path, int argc, char **argv)
+{
+    SyntheticFeedConfig config;
+    if (argc > 3)
+        config.num_events = std::strtoull(argv[3], nullptr, 10);
+    if (argc > 4)
+        config.num_symbols = static_cast<u32_t>(std::strtoul(argv[4], nullptr, 10));
+    if (argc > 5)
+        config.seed = std::strtoull(argv[5], nullptr, 10);
+
+    const auto records = make_synthetic_feed(config);
+    if (!write_feed(path, records))
+    {
+        std::cerr << "failed to write " << path << '\n';
+        return 1;
+    }
+    std::cout << "wrote " << records.size() << " events for " << config.num_symbols << " symbol(s) to " << path
+              << '\n';
+    return 0;
+}
+
+template <class Book> static ReplayStats ReplayInto(const FeedReader &feed, ReplayConfig config, auto make_book)
+{
+    const SymbolId num_symbols = feed.num_symbols();
+    std::vector<Book> books;
+    books.reserve(num_symbols);
+    for (SymbolId s = 0; s < num_symbols; ++s)
+        books.emplace_back(make_book());
+    return replay_feed(std::span<Book>{books}, feed.records(), config);
+}
+
+static int Replay(const std::string &path, int argc, char **argv)
+{
+    ReplayConfig config;
+    bool vector_book = false;
+    for (int i = 3; i < argc; ++i)
+    {
+        const std::string_view arg{argv[i]};
+        if (arg == "--paced")
+            config.paced = true;
+        else if (arg == "--speed" && i + 1 < argc)
+            config.speed = std::strtod(argv[++i], nullptr);
+        else if (arg == "--vector")
+            vector_book = true;
+        else
+            return Usage();
+    }
+
+    auto feed = FeedReader::open(path);
+    if (!feed)
+    {
+        std::cerr << "failed to open feed " << path << " (error " << static_cast<int>(feed.error()) << ")\n";
+        return 1;
+    }
+
+    const ReplayStats stats =
+        vector_book ? ReplayInto<Orderbook>(*feed, config, [] { return Orderbook{}; })
+                    : ReplayInto<LadderOrderbook>(*feed, config, [] { return LadderOrderbook{1 << 14, 1 << 20}; });
+
+    std::cout << "messages   " << stats.messages << " (" << stats.skipped << " skipped)\n"
+              << "trades     " << stats.trades << '\n'
+              << "elapsed    " << static_cast<double>(stats.elapsed_ns) / 1e6 << " ms\n"
+              << "throughput " << stats.msgs_per_sec / 1e6 << " M msgs/s\n"
+              << "latency ns p50 " << stats.p50_ns << "  p90 " << stats.p90_ns << "  p99 " << stats.p99_ns
+              << "  p99.9 " << stats.p999_ns << "  max " << stats.max_ns << '\n';
+    return 0;
+}
+} // End namespace fiah
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+        return fiah::Usage();
+
+    const std::string_view cmd{argv[1]};
+    if (cmd == "gen")
+        return fiah::Generate(argv[2], argc, argv);
+    if (cmd == "replay")
+        return fiah::Replay(argv[2], argc, argv);
+    return fiah::Usage();
+}
@@ -0,0 +1,105 @@
+// C++ Includes
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// FastInAHurry Includes
+#include "fiah/engine/FeedReplay.hh"
+#include "fiah/engine/Pipeline.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+
+namespace fiah
+{
+static int Usage()
+{
+    std::cerr << "usage: pipeline_example [--events N] [--rate MSGS_PER_SEC] [--cores RX,BOOK,TX,SEND,RECV] "
+                 "[--yield]\n";
+    return 1;
+}
+
+/// Parses "a,b,c,d,e" into one core id per thread
+static bool ParseCores(std::string_view list, std::vector<int> &out)
+{
+    out.clear();
+    while (!list.empty())
+    {
+        const auto comma = list.find(',');
+        out.push_back(std::atoi(std::string{list.substr(0, comma)}.c_str()));
+        if (comma == std::string_view::npos)
+            break;
+        list.remove_prefix(comma + 1);
+    }
+    return out.size() == 5;
+}
+
+static int Run(int argc, char **argv)
+{
+    u64_t num_events = 200'000;
+    u64_t rate = 100'000;
+    bool yield = false;
+    std::vector<int> cores{-1, -1, -1, -1, -1};
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{argv[i]};
+        if (arg == "--events" && i + 1 < argc)
+            num_events = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--rate" && i + 1 < argc)
+            rate = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--cores" && i + 1 < argc)
+        {
+            if (!ParseCores(argv[++i], cores))
+                return Usage();
+        }
+        else if (arg == "--yield")
+            yield = true;
+        else
+            return Usage();
+    }
+
+    auto load = LoadGenerator::create(
+        {.rate = rate, .send_core = cores[3], .recv_core = cores[4], .yield_when_idle = yield});
+    if (!load)
+    {
+        std::cerr << "cannot bind the load generator's trade listener\n";
+        return 1;
+    }
+    auto pipeline = MatchingPipeline<>::start(LadderOrderbook{1 << 14, 1 << 20},
+                                              {.egress_port = load->listen_port(),
+                                               .rx_core = cores[0],
+                                               .book_core = cores[1],
+                                               .tx_core = cores[2],
+                                               .yield_when_idle = yield});
+    if (!pipeline)
+    {
+        std::cerr << "cannot start the pipeline (error " << static_cast<int>(pipeline.error()) << ")\n";
+        return 1;
+    }
+
+    std::vector<OrderEvent> events;
+    events.reserve(num_events);
+    for (const FeedRecord &record : make_synthetic_feed({.num_events = num_events, .aggressive_pct = 20}))
+        events.push_back(record.event);
+
+    const LoadReport report = load->run((*pipeline)->ingress_port(), events);
+    (*pipeline)->stop();
+    const PipelineStats stats = (*pipeline)->stats();
+
+    std::cout << "sent       " << report.sent << " (" << report.send_errors << " send errors)\n"
+              << "pipeline   " << stats.received << " received, " << stats.malformed << " malformed, "
+              << stats.ingress_drops << " ingress drops, " << stats.trades << " trades, " << stats.egress_drops
+              << " egress drops, " << stats.sent << " sent\n"
+              << "trades in  " << report.trades_received << '\n'
+              << "elapsed    " << static_cast<double>(report.elapsed_ns) / 1e6 << " ms\n"
+              << "wire-to-wire ns p50 " << report.p50_ns << "  p90 " << report.p90_ns << "  p99 " << report.p99_ns
+              << "  p99.9 " << report.p999_ns << "  max " << report.max_ns << '\n';
+    return 0;
+}
+} // End namespace fiah
+
+int main(int argc, char **argv)
+{
+    return fiah::Run(argc, argv);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+// C++ Includes
+#include <span>
+
+// FastInAHurry Includes
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/structs/SeqLock.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Top of book. A side with zero quantity is empty and its price is
+/// meaningless.
+struct Bbo
+{
+    Price bid_price{};
+    Quantity bid_qty{};
+    u32_t bid_count{};
+    Price ask_price{};
+    Quantity ask_qty{};
+    u32_t ask_count{};
+
+    bool operator==(const Bbo &) const noexcept = default;
+
+    [[nodiscard]] bool has_bid() const noexcept
+    {
+        return bid_qty > 0;
+    }
+
+    [[nodiscard]] bool has_ask() const noexcept
+    {
+        return ask_qty > 0;
+    }
+};
+static_assert(sizeof(Bbo) == 32);
+
+/// @brief Any book that can report its aggregated best levels.
+template <class Book>
+concept DepthSource = requires(const Book &book, std::span<DepthLevel> out) {
+    { book.top_levels(Order::Side::BUY, out) } -> std::convertible_to<sz_t>;
+};
+
+template <DepthSource Book> Bbo read_bbo(const Book &book) noexcept
+{
+    DepthLevel level[1];
+    Bbo bbo;
+    if (book.top_levels(Order::Side::BUY, level) == 1)
+    {
+        bbo.bid_price = level[0].price;
+        bbo.bid_qty = level[0].qty;
+        bbo.bid_count = level[0].count;
+    }
+    if (book.top_levels(Order::Side::SELL, level) == 1)
+    {
+        bbo.ask_price = level[0].price;
+        bbo.ask_qty = level[0].qty;
+        bbo.ask_count = level[0].count;
+    }
+    return bbo;
+}
+
+/// @brief Publishes one book's top of book to readers on other threads.
+///
+/// The book thread calls update() after each event it applies; the SeqLock is
+/// only written when the BBO actually differs from the last one published, so
+/// events deeper in the book cost one comparison and no shared-line traffic.
+/// Strategy threads call read() (or try_read()) as often as they like.
+///
+/// @attention update() belongs to the thread that owns the book.
+class BboPublisher
+{
+  public:
+    /// @return True if the BBO changed and was republished.
+    template <DepthSource Book> bool update(const Book &book) noexcept
+    {
+        const Bbo now = read_bbo(book);
+        if (now == m_last)
+            return false;
+        m_last = now;
+        m_lock.store(now);
+        return true;
+    }
+
+    [[nodiscard]] Bbo read() const noexcept
+    {
+        return m_lock.load();
+    }
+
+    /// @brief Non-blocking read for readers that would rather skip a beat
+    /// than spin behind a store.
+    [[nodiscard]] bool try_read(Bbo &out) const noexcept
+    {
+        return m_lock.try_load(out);
+    }
+
+    /// @return Number of times the BBO has changed.
+    [[nodiscard]] u64_t version() const noexcept
+    {
+        return m_lock.version();
+    }
+
+  private:
+    SeqLock<Bbo> m_lock;
+    alignas(cacheline_t::value) Bbo m_last{}; // writer-private, off the readers' line
+};
+
+} // End namespace fiah
@@ -0,0 +1,200 @@
+#pragma once
+
+// C++ Includes
+#include <x86intrin.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// FastInAHurry Includes
+#include "fiah/engine/OrderEvent.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/thread/Affinity.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Default per-shard trade handler: counts trades.
+struct TradeCounter
+{
+    u64_t trades{};
+
+    void operator()(SymbolId, const Trade &) noexcept
+    {
+        ++trades;
+    }
+};
+
+/// @brief Owns one book per symbol and shards them across worker threads.
+///
+/// Symbol `s` lives on shard `s % num_shards`. Every shard has its own
+/// SPSCQueue of OrderEvents, its own books and its own trade handler, and is
+/// the only thread that ever touches them, so the matching path takes no locks
+/// and shares no cache lines with other shards.
+///
+/// Books are built up front and keep their capacity for life, so the
+/// manager's footprint is num_symbols times one book. A LadderOrderbook
+/// costs about num_levels * 24 + max_orders * 72 bytes (levels, node pool
+/// and a half-full id index); its defaults of 4096 levels and 65536 orders
+/// come to ~4.6 MiB, which is gigabytes across thousands of symbols and evicts
+/// every shard's working set. Size each book for its symbol's real depth
+/// in `make_book`; 256 levels and 1024 orders is ~78 KiB.
+///
+/// @attention submit() is the producer side of every shard queue: call it from
+/// one thread only.
+/// @tparam Book Order book type, constructed once per symbol.
+/// @tparam OnTrade Called as `on_trade(symbol, trade)` on the shard thread.
+/// Each shard owns a separate copy.
+/// @tparam QUEUE_SIZE Per-shard event queue capacity (power of two).
+template <class Book = LadderOrderbook, class OnTrade = TradeCounter, sz_t QUEUE_SIZE = (1 << 14)>
+class BookManager
+{
+  public:
+    using QueueT = SPSCQueue<OrderEvent, QUEUE_SIZE>;
+
+    /// @param make_book Called once per symbol to construct its book. There
+    /// is deliberately no default: see the class note on memory per symbol.
+    /// @param cores Optional core per shard; shard i is pinned to cores[i]
+    /// when present and non-negative.
+    template <class MakeBook>
+        requires std::is_invocable_r_v<Book, MakeBook &>
+    BookManager(sz_t num_symbols, sz_t num_shards, MakeBook make_book, std::vector<int> cores = {})
+        : m_num_symbols{num_symbols}
+    {
+        num_shards = std::max(num_shards, sz_t{1});
+        m_shards.reserve(num_shards);
+        for (sz_t i = 0; i < num_shards; ++i)
+        {
+            auto shard = std::make_unique<Shard>();
+            const sz_t num_books = num_symbols / num_shards + (i < num_symbols % num_shards ? 1 : 0);
+            shard->books.reserve(num_books);
+            for (sz_t b = 0; b < num_books; ++b)
+                shard->books.emplace_back(make_book());
+            m_shards.push_back(std::move(shard));
+        }
+
+        for (sz_t i = 0; i < num_shards; ++i)
+        {
+            const int core = i < cores.size() ? cores[i] : -1;
+            Shard &shard = *m_shards[i];
+            shard.worker =
+                std::jthread{[&shard, core, num_shards](std::stop_token st) { _run(shard, core, num_shards, st); }};
+        }
+    }
+
+    BookManager(const BookManager &) = delete;
+    BookManager &operator=(const BookManager &) = delete;
+
+    ~BookManager() noexcept
+    {
+        stop();
+    }
+
+    /// @brief Enqueues an event for its symbol's shard.
+    /// @return False if the symbol is unknown or the shard queue is full.
+    [[nodiscard, gnu::always_inline]]
+    bool submit(const OrderEvent &event) noexcept
+    {
+        if (event.symbol >= m_num_symbols) [[unlikely]]
+            return false;
+        Shard &shard = *m_shards[event.symbol % m_shards.size()];
+        if (!shard.queue->push(event))
+            return false;
+        ++shard.submitted;
+        return true;
+    }
+
+    /// @brief Spins until every submitted event has been applied.
+    void drain() const noexcept
+    {
+        for (const auto &shard : m_shards)
+        {
+            while (shard->processed.load(std::memory_order_acquire) != shard->submitted)
+                _mm_pause();
+        }
+    }
+
+    /// @brief Drains the queues and joins the workers. Idempotent.
+    void stop() noexcept
+    {
+        for (auto &shard : m_shards)
+            shard->worker.request_stop();
+        for (auto &shard : m_shards)
+        {
+            if (shard->worker.joinable())
+                shard->worker.join();
+        }
+    }
+
+    /// @attention Only safe after drain() or stop().
+    Book &book(SymbolId symbol) noexcept
+    {
+        return m_shards[symbol % m_shards.size()]->books[symbol / m_shards.size()];
+    }
+
+    /// @attention Only safe after drain() or stop().
+    const OnTrade &trade_handler(sz_t shard) const noexcept
+    {
+        return m_shards[shard]->on_trade;
+    }
+
+    sz_t num_shards() const noexcept
+    {
+        return m_shards.size();
+    }
+
+    sz_t num_symbols() const noexcept
+    {
+        return m_num_symbols;
+    }
+
+  private:
+    struct Shard
+    {
+        std::unique_ptr<QueueT> queue{std::make_unique<QueueT>()};
+        std::vector<Book> books{};
+        OnTrade on_trade{};
+        alignas(cacheline_t::value) std::atomic<u64_t> processed{0}; // written by the shard thread
+        alignas(cacheline_t::value) u64_t submitted{0};              // written by the producer
+        std::jthread worker{}; // declared last: joined before the rest is torn down
+    };
+
+    sz_t m_num_symbols;
+    std::vector<std::unique_ptr<Shard>> m_shards;
+
+    static void _run(Shard &shard, int core, sz_t num_shards, std::stop_token st) noexcept
+    {
+        if (core >= 0)
+            (void)pin_this_thread(core);
+
+        OrderEvent event;
+        auto on_trade = [&shard, &event](const Trade &trade) { shard.on_trade(event.symbol, trade); };
+        auto apply = [&] {
+            apply_event(shard.books[event.symbol / num_shards], event, on_trade);
+            // Single writer: a plain store is enough to publish progress
+            shard.processed.store(shard.processed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        };
+
+        while (!st.stop_requested())
+        {
+            if (shard.queue->pop(event))
+                apply();
+            else
+                _mm_pause();
+        }
+        while (shard.queue->pop(event))
+            apply();
+    }
+};
+
+} // End namespace fiah
@@ -0,0 +1,158 @@
+#pragma once
+
+// C++ Includes
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <span>
+
+// FastInAHurry Includes
+#include "fiah/engine/Bbo.hh"
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/structs/SeqLock.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Conflating hand-off of a book's top `LEVELS` levels per side from
+/// the book thread to a market-data publisher.
+///
+/// Instead of queueing every level change, each level has one latest-value
+/// slot (a SeqLock) and one dirty bit. The book thread overwrites slots and
+/// sets bits; the publisher takes all the bits of a side in one exchange and
+/// copies out only those slots. However long the burst, the publisher does
+/// at most 2 * LEVELS slot reads per drain, memory is fixed, and what it reads
+/// is always the newest value of each level. Intermediate states in between
+/// two drains are, by design, never seen.
+///
+/// Slots are ordinal: slot 0 is the best level. A level that disappears is
+/// published as an empty DepthLevel (zero qty and count).
+///
+/// @attention publish() and update() belong to the thread that owns the book;
+/// drain() to one publisher thread. level() is safe from any thread.
+template <sz_t LEVELS = 10>
+    requires(LEVELS > 0 && LEVELS <= 64)
+class ConflatedDepth
+{
+  public:
+    ConflatedDepth() = default;
+    ConflatedDepth(const ConflatedDepth &) = delete;
+    ConflatedDepth &operator=(const ConflatedDepth &) = delete;
+
+    static constexpr sz_t levels() noexcept
+    {
+        return LEVELS;
+    }
+
+    /// @brief Sets one slot if it changed. For books that track which level
+    /// an event touched and want to skip the full top-of-book read.
+    /// @pre level < LEVELS
+    /// @return True if the slot changed; false for an unchanged slot or, in
+    /// release builds, a level past the last slot.
+    bool update(OrderSide side, sz_t level, const DepthLevel &value) noexcept
+    {
+        assert(level < LEVELS);
+        if (level >= LEVELS) [[unlikely]]
+            return false;
+        Side &s = m_sides[_index(side)];
+        if (!_store(s, level, value))
+            return false;
+        s.dirty.fetch_or(u64_t{1} << level, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Reads the book's top levels and republishes the ones that
+    /// differ from what was last published, with one dirty-bit RMW per side
+    /// that changed. Call after each applied event.
+    /// @return Number of slots that changed.
+    template <DepthSource Book> sz_t publish(const Book &book) noexcept
+    {
+        sz_t changed = 0;
+        for (OrderSide side : {OrderSide::BUY, OrderSide::SELL})
+        {
+            Side &s = m_sides[_index(side)];
+            std::array<DepthLevel, LEVELS> top{};
+            book.top_levels(side, std::span<DepthLevel>{top});
+            u64_t bits = 0;
+            for (sz_t i = 0; i < LEVELS; ++i)
+                bits |= u64_t{_store(s, i, top[i])} << i;
+            // Release after the slot stores: whoever takes a bit sees its slot
+            if (bits)
+                s.dirty.fetch_or(bits, std::memory_order_release);
+            changed += static_cast<sz_t>(std::popcount(bits));
+        }
+        return changed;
+    }
+
+    /// @brief Hands every level that changed since the last drain to
+    /// `on_level(side, level, value)`, newest value only, then clears it.
+    /// @return Number of levels delivered.
+    template <class OnLevel>
+        requires std::invocable<OnLevel &, OrderSide, sz_t, const DepthLevel &>
+    sz_t drain(OnLevel &&on_level)
+    {
+        sz_t delivered = 0;
+        for (OrderSide side : {OrderSide::BUY, OrderSide::SELL})
+        {
+            Side &s = m_sides[_index(side)];
+            if (!s.dirty.load(std::memory_order_relaxed))
+                continue;
+            // Taking the bits before reading the slots: a store that lands
+            // after this exchange sets its bit again, so nothing is lost
+            for (u64_t bits = s.dirty.exchange(0, std::memory_order_acquire); bits; bits &= bits - 1)
+            {
+                const auto level = static_cast<sz_t>(std::countr_zero(bits));
+                on_level(side, level, s.slots[level].load());
+                ++delivered;
+            }
+        }
+        return delivered;
+    }
+
+    /// @return True if a drain() would deliver anything.
+    [[nodiscard]] bool dirty() const noexcept
+    {
+        return m_sides[0].dirty.load(std::memory_order_relaxed) | m_sides[1].dirty.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Latest value of one slot, without touching the dirty bits.
+    [[nodiscard]] DepthLevel level(OrderSide side, sz_t level) const noexcept
+    {
+        return m_sides[_index(side)].slots[level].load();
+    }
+
+  private:
+    // One dirty bit per level
+    static_assert(LEVELS <= 64);
+
+    struct Side
+    {
+        alignas(cacheline_t::value) std::atomic<u64_t> dirty{0};
+        std::array<SeqLock<DepthLevel>, LEVELS> slots{};
+        std::array<DepthLevel, LEVELS> shadow{}; // writer-private
+    };
+
+    static constexpr sz_t _index(OrderSide side) noexcept
+    {
+        return side == OrderSide::BUY ? 0 : 1;
+    }
+
+    /// Writes the slot if it differs from the writer's shadow copy.
+    static bool _store(Side &s, sz_t level, const DepthLevel &value) noexcept
+    {
+        DepthLevel &last = s.shadow[level];
+        if (last.price == value.price && last.qty == value.qty && last.count == value.count)
+            return false;
+        last = value;
+        s.slots[level].store(value);
+        return true;
+    }
+
+    std::array<Side, 2> m_sides{};
+};
+
+} // End namespace fiah
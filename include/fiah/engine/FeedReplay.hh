@@ -0,0 +1,367 @@
+#pragma once
+
+// C++ Includes
+#include <fcntl.h>
+#include <unistd.h>
+#include <x86intrin.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// FastInAHurry Includes
+#include "fiah/engine/OrderEvent.hh"
+#include "fiah/error/Error.hh"
+#include "fiah/io/MappedFile.hh"
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/utils/Types.hh"
+#include "fiah/utils/XorBitant.hh"
+
+namespace fiah
+{
+
+/// @brief One timestamped event in a feed file.
+struct FeedRecord
+{
+    u64_t timestamp_ns; ///< Capture time, relative to the first record
+    OrderEvent event;
+};
+static_assert(sizeof(FeedRecord) == 40);
+static_assert(std::is_trivially_copyable_v<FeedRecord>);
+
+/// @brief Fixed header at offset 0 of a feed file, followed by `count`
+/// packed FeedRecords in native byte order.
+struct FeedHeader
+{
+    static constexpr u64_t MAGIC{0x4445'4546'4841'4946ULL}; // "FIAHFEED"
+    static constexpr u32_t VERSION{2}; // 2: OrderEvent carries Order::Type
+
+    u64_t magic{MAGIC};
+    u32_t version{VERSION};
+    u32_t record_size{sizeof(FeedRecord)};
+    u64_t count{0};
+    u64_t reserved{0};
+};
+static_assert(sizeof(FeedHeader) == 32);
+static_assert(sizeof(FeedHeader) % alignof(FeedRecord) == 0);
+
+/// @brief Writes `records` to `path` in the feed format, replacing any
+/// existing file. Records are copied field by field into a zeroed buffer, so
+/// OrderEvent's padding is written as zeros, never as the caller's memory.
+inline auto write_feed(const std::string &path, std::span<const FeedRecord> records) -> std::expected<void, FileError>
+{
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return std::unexpected(FileError::OPEN_FAIL);
+
+    auto write_all = [fd](const void *buf, sz_t len) {
+        const auto *p = static_cast<const char *>(buf);
+        while (len > 0)
+        {
+            const ssize_t n = ::write(fd, p, len);
+            if (n <= 0)
+                return false;
+            p += n;
+            len -= static_cast<sz_t>(n);
+        }
+        return true;
+    };
+
+    constexpr sz_t CHUNK{4096};
+    std::vector<FeedRecord> chunk(std::min(CHUNK, records.size()));
+    const FeedHeader header{.count = records.size()};
+    bool ok = write_all(&header, sizeof(header));
+    for (sz_t i = 0; ok && i < records.size(); i += chunk.size())
+    {
+        const auto batch = records.subspan(i, std::min(chunk.size(), records.size() - i));
+        std::memset(static_cast<void *>(chunk.data()), 0, batch.size_bytes());
+        for (sz_t j = 0; j < batch.size(); ++j)
+        {
+            const FeedRecord &in = batch[j];
+            FeedRecord &out = chunk[j];
+            out.timestamp_ns = in.timestamp_ns;
+            out.event.id = in.event.id;
+            out.event.price = in.event.price;
+            out.event.qty = in.event.qty;
+            out.event.symbol = in.event.symbol;
+            out.event.type = in.event.type;
+            out.event.is_buy = in.event.is_buy;
+            out.event.order_type = in.event.order_type;
+        }
+        ok = write_all(chunk.data(), batch.size_bytes());
+    }
+    ::close(fd);
+    if (!ok)
+        return std::unexpected(FileError::WRITE_FAIL);
+    return {};
+}
+
+/// @brief Zero-copy view of a feed file. Records are read straight out of the
+/// mapping; nothing is decoded or copied. open() makes one validating pass so
+/// that a corrupt file is rejected before any record reaches a book.
+class FeedReader
+{
+  public:
+    /// Symbols at or above this are treated as corruption unless the caller
+    /// passes a larger limit.
+    static constexpr SymbolId DEFAULT_SYMBOL_LIMIT{1 << 16};
+
+    /// @return BAD_RECORD if any record has an out-of-range type, order type
+    /// or side byte, a symbol at or above `symbol_limit`, or a timestamp
+    /// earlier than the record before it.
+    static auto open(const std::string &path, bool populate = true, SymbolId symbol_limit = DEFAULT_SYMBOL_LIMIT)
+        -> std::expected<FeedReader, FileError>
+    {
+        auto file = MappedFile::open(path, populate);
+        if (!file)
+            return std::unexpected(file.error());
+        if (file->size() < sizeof(FeedHeader))
+            return std::unexpected(FileError::BAD_HEADER);
+
+        FeedHeader header;
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (header.magic != FeedHeader::MAGIC || header.version != FeedHeader::VERSION ||
+            header.record_size != sizeof(FeedRecord))
+            return std::unexpected(FileError::BAD_HEADER);
+        if ((file->size() - sizeof(FeedHeader)) / sizeof(FeedRecord) < header.count)
+            return std::unexpected(FileError::TRUNCATED);
+
+        FeedReader reader{std::move(*file), header.count};
+        u64_t last_ts = 0;
+        for (const FeedRecord &record : reader.records())
+        {
+            if (!is_well_formed(record.event) || record.event.symbol >= symbol_limit ||
+                record.timestamp_ns < last_ts) [[unlikely]]
+                return std::unexpected(FileError::BAD_RECORD);
+            last_ts = record.timestamp_ns;
+            reader.m_num_symbols = std::max(reader.m_num_symbols, record.event.symbol + 1);
+        }
+        return reader;
+    }
+
+    [[nodiscard]] std::span<const FeedRecord> records() const noexcept
+    {
+        return {reinterpret_cast<const FeedRecord *>(m_file.data() + sizeof(FeedHeader)), m_count};
+    }
+
+    [[nodiscard]] sz_t size() const noexcept
+    {
+        return m_count;
+    }
+
+    /// One past the highest symbol in the file: how many books to build.
+    [[nodiscard]] SymbolId num_symbols() const noexcept
+    {
+        return m_num_symbols;
+    }
+
+  private:
+    MappedFile m_file;
+    sz_t m_count;
+    SymbolId m_num_symbols{0};
+
+    FeedReader(MappedFile file, sz_t count) noexcept : m_file{std::move(file)}, m_count{count}
+    {
+    }
+};
+
+/// @brief How far from mid synthetic adds are priced.
+enum class PriceSkew : u8_t
+{
+    UNIFORM,    ///< Every offset in range equally likely
+    NEAR_TOUCH, ///< Quadratic bias toward mid, like real queue shapes
+};
+
+/// @brief Knobs for make_synthetic_feed(). Percentages are out of 100.
+struct SyntheticFeedConfig
+{
+    u64_t num_events{1'000'000};
+    u32_t num_symbols{1};
+    Price mid{100'000};
+    Price depth{64};         ///< Passive adds land 1..depth ticks from mid
+    u32_t cancel_pct{35};    ///< Share of events cancelling a live order
+    u32_t modify_pct{10};    ///< Share of events modifying a live order
+    u32_t aggressive_pct{8}; ///< Share of adds priced through mid
+    PriceSkew skew{PriceSkew::UNIFORM};
+    Quantity max_qty{100};   ///< Clamped to at least 1
+    u64_t mean_gap_ns{1'000}; ///< Mean spacing of timestamps
+    u64_t seed{0xFEED};
+};
+
+/// @brief Deterministic add/cancel/modify stream with a random-walking mid
+/// per symbol. Cancels and modifies target ids that were added earlier (some
+/// may since have traded away, as on a real feed).
+inline std::vector<FeedRecord> make_synthetic_feed(const SyntheticFeedConfig &config)
+{
+    struct Live
+    {
+        Id id;
+        Price price;
+        SymbolId symbol;
+    };
+
+    XorBitant rng{config.seed};
+    const u32_t num_symbols = std::max(config.num_symbols, u32_t{1});
+    const Price depth = std::max(config.depth, Price{1});
+    const auto max_qty = static_cast<u32_t>(std::max(config.max_qty, Quantity{1}));
+    const u64_t gap_span = 2 * config.mean_gap_ns + 1;
+    std::vector<Price> mids(num_symbols, config.mid);
+    std::vector<Live> live;
+    std::vector<FeedRecord> records;
+    records.reserve(config.num_events);
+
+    Id next_id = 1;
+    u64_t now = 0;
+    for (u64_t n = 0; n < config.num_events; ++n)
+    {
+        now += rng() % gap_span;
+        const u32_t roll = rng() % 100;
+
+        if (!live.empty() && roll < config.cancel_pct + config.modify_pct)
+        {
+            const sz_t pick = rng() % live.size();
+            Live &target = live[pick];
+            if (roll < config.cancel_pct)
+            {
+                records.push_back({now, OrderEvent::cancel(target.symbol, target.id)});
+                target = live.back();
+                live.pop_back();
+            }
+            else
+            {
+                // Half shrink in place, half re-price by a tick (loses priority)
+                if (rng() & 1)
+                    target.price += (rng() & 1) ? 1 : -1;
+                const auto qty = 1 + static_cast<Quantity>(rng() % max_qty);
+                records.push_back({now, OrderEvent::modify(target.symbol, target.id, qty, target.price)});
+            }
+            continue;
+        }
+
+        const SymbolId symbol = rng() % num_symbols;
+        Price &mid = mids[symbol];
+        if (rng() % 16 == 0)
+            mid += (rng() & 1) ? 1 : -1;
+
+        const bool is_buy = (rng() & 1) != 0;
+        const bool aggressive = rng() % 100 < config.aggressive_pct;
+        const auto range = static_cast<u64_t>(aggressive ? depth / 4 + 1 : depth);
+        u64_t draw = rng() % range;
+        if (config.skew == PriceSkew::NEAR_TOUCH)
+            draw = draw * draw / range;
+        const auto offset = 1 + static_cast<Price>(draw);
+        const Price price = (is_buy != aggressive) ? mid - offset : mid + offset;
+        const auto qty = 1 + static_cast<Quantity>(rng() % max_qty);
+
+        records.push_back({now, OrderEvent::add(symbol, Order{next_id, price, is_buy, qty})});
+        live.push_back({next_id, price, symbol});
+        ++next_id;
+    }
+    return records;
+}
+
+struct ReplayConfig
+{
+    bool paced{false}; ///< Honour record timestamps instead of running flat out
+    double speed{1.0}; ///< Pacing multiplier, e.g. 10.0 replays 10x faster
+};
+
+/// @brief Outcome of replay_feed(). Latencies cover the book call only, not
+/// time spent waiting for the next record's timestamp.
+struct ReplayStats
+{
+    u64_t messages{};
+    u64_t skipped{}; ///< Records addressed to a symbol with no book, or malformed
+    u64_t trades{};
+    u64_t elapsed_ns{};
+    double msgs_per_sec{};
+    u64_t p50_ns{};
+    u64_t p90_ns{};
+    u64_t p99_ns{};
+    u64_t p999_ns{};
+    u64_t max_ns{};
+};
+
+/// @brief Streams `records` through `books` (indexed by symbol) and measures
+/// each book call with the TSC. Cycles are converted to nanoseconds against
+/// the steady clock over the whole run, so no calibration step is needed.
+/// Records that did not come through FeedReader are checked here too; bad
+/// ones are skipped rather than applied, and when paced, a timestamp before
+/// the first record's is due immediately.
+template <class Book, TradeSink Sink>
+ReplayStats replay_feed(std::span<Book> books, std::span<const FeedRecord> records, ReplayConfig config,
+                        Sink &&sink)
+{
+    using Clock = std::chrono::steady_clock;
+
+    ReplayStats stats;
+    std::vector<u64_t> cycles;
+    cycles.reserve(records.size());
+    auto on_trade = [&stats, &sink](const Trade &trade) {
+        ++stats.trades;
+        sink(trade);
+    };
+
+    const u64_t first_ts = records.empty() ? 0 : records.front().timestamp_ns;
+    const double speed = config.speed > 0.0 ? config.speed : 1.0;
+    const auto wall_start = Clock::now();
+    const u64_t tsc_start = __rdtsc();
+
+    for (const FeedRecord &record : records)
+    {
+        if (record.event.symbol >= books.size() || !is_well_formed(record.event)) [[unlikely]]
+        {
+            ++stats.skipped;
+            continue;
+        }
+        if (config.paced)
+        {
+            const u64_t offset_ns = record.timestamp_ns > first_ts ? record.timestamp_ns - first_ts : 0;
+            const auto due =
+                wall_start + std::chrono::nanoseconds{static_cast<i64_t>(static_cast<double>(offset_ns) / speed)};
+            while (Clock::now() < due)
+                _mm_pause();
+        }
+
+        const u64_t t0 = __rdtsc();
+        apply_event(books[record.event.symbol], record.event, on_trade);
+        cycles.push_back(__rdtsc() - t0);
+    }
+
+    const u64_t tsc_total = __rdtsc() - tsc_start;
+    stats.elapsed_ns = static_cast<u64_t>(std::chrono::nanoseconds{Clock::now() - wall_start}.count());
+    stats.messages = cycles.size();
+    if (stats.elapsed_ns > 0)
+        stats.msgs_per_sec = static_cast<double>(stats.messages) * 1e9 / static_cast<double>(stats.elapsed_ns);
+    if (cycles.empty() || tsc_total == 0)
+        return stats;
+
+    const double ns_per_cycle = static_cast<double>(stats.elapsed_ns) / static_cast<double>(tsc_total);
+    auto percentile = [&cycles, ns_per_cycle](double q) {
+        const auto rank = static_cast<sz_t>(q * static_cast<double>(cycles.size() - 1));
+        std::nth_element(cycles.begin(), cycles.begin() + static_cast<std::ptrdiff_t>(rank), cycles.end());
+        return static_cast<u64_t>(static_cast<double>(cycles[rank]) * ns_per_cycle);
+    };
+    stats.p50_ns = percentile(0.50);
+    stats.p90_ns = percentile(0.90);
+    stats.p99_ns = percentile(0.99);
+    stats.p999_ns = percentile(0.999);
+    stats.max_ns = percentile(1.0);
+    return stats;
+}
+
+template <class Book>
+ReplayStats replay_feed(std::span<Book> books, std::span<const FeedRecord> records, ReplayConfig config = {})
+{
+    return replay_feed(books, records, config, [](const Trade &) {});
+}
+
+} // End namespace fiah
@@ -0,0 +1,510 @@
+#pragma once
+
+// C++ Includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// FastInAHurry Includes
+#include "fiah/engine/OrderEvent.hh"
+#include "fiah/error/Error.hh"
+#include "fiah/io/MappedFile.hh"
+#include "fiah/thread/Affinity.hh"
+#include "fiah/utils/CacheLine.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief One journaled event. `seq` and `check` let recovery find the end
+/// of the valid prefix without a separately persisted length: a slot is
+/// valid only if its seq is the next expected one and its checksum matches.
+struct JournalRecord
+{
+    u64_t seq;
+    OrderEvent event;
+    u64_t check;
+
+    [[nodiscard]] static u64_t checksum(u64_t seq, const OrderEvent &event) noexcept
+    {
+        u64_t words[sizeof(OrderEvent) / sizeof(u64_t)];
+        std::memcpy(words, &event, sizeof(words));
+        u64_t h = seq * 0x9E37'79B9'7F4A'7C15ULL;
+        for (const u64_t w : words)
+        {
+            h = (h ^ w) * 0xFF51'AFD7'ED55'8CCDULL;
+            h ^= h >> 32;
+        }
+        return h;
+    }
+
+    [[nodiscard]] bool valid(u64_t expected_seq) const noexcept
+    {
+        return seq == expected_seq && check == checksum(seq, event);
+    }
+};
+static_assert(sizeof(JournalRecord) == 48);
+static_assert(std::is_trivially_copyable_v<JournalRecord>);
+
+/// @brief Fixed header at offset 0 of a journal segment, followed by
+/// `capacity` JournalRecord slots.
+struct JournalHeader
+{
+    static constexpr u64_t MAGIC{0x4C4E'524A'4841'4946ULL}; // "FIAHJRNL"
+    static constexpr u32_t VERSION{1};
+
+    u64_t magic{MAGIC};
+    u32_t version{VERSION};
+    u32_t record_size{sizeof(JournalRecord)};
+    u64_t capacity{0};
+    u64_t base_seq{1}; ///< Sequence number of slot 0
+    u64_t reserved[4]{};
+};
+static_assert(sizeof(JournalHeader) == 64);
+static_assert(sizeof(JournalHeader) % alignof(JournalRecord) == 0);
+
+struct JournalConfig
+{
+    /// Group-commit window: the flusher syncs whatever accumulated at most
+    /// this often, so one msync covers every event appended in between
+    std::chrono::microseconds flush_interval{1000};
+    int flusher_core{-1}; ///< Pin the flusher thread here when non-negative
+};
+
+namespace detail
+{
+/// @return How many leading slots of `records` form an unbroken run from
+/// `base_seq`.
+inline sz_t journal_valid_prefix(std::span<const JournalRecord> records, u64_t base_seq) noexcept
+{
+    sz_t n = 0;
+    while (n < records.size() && records[n].valid(base_seq + n))
+        ++n;
+    return n;
+}
+
+/// @param file_size Size of the whole segment file, header included.
+inline auto check_journal_header(const JournalHeader &header, sz_t file_size) -> std::expected<void, FileError>
+{
+    if (header.magic != JournalHeader::MAGIC || header.version != JournalHeader::VERSION ||
+        header.record_size != sizeof(JournalRecord) || header.base_seq == 0 || header.capacity == 0)
+        return std::unexpected(FileError::BAD_HEADER);
+    if ((file_size - sizeof(JournalHeader)) / sizeof(JournalRecord) < header.capacity)
+        return std::unexpected(FileError::TRUNCATED);
+    return {};
+}
+} // namespace detail
+
+/// @brief Append-only write-ahead journal of book events in a preallocated,
+/// memory-mapped segment file.
+///
+/// append() is a memcpy into the shared mapping plus a release store: no
+/// syscall, no lock, no allocation. A background flusher wakes every
+/// `flush_interval`, msyncs the pages written since its last pass and
+/// advances durable_seq(), so the cost of making events durable is shared by
+/// everything appended within one window (group commit). Callers that must
+/// not acknowledge before durability can wait_durable() or flush().
+///
+/// The segment is allocated on disk up front (posix_fallocate), so a full
+/// filesystem shows up at create() instead of as SIGBUS on the hot path.
+///
+/// @attention append(), reset(), last_seq() and size() (and so checkpoint())
+/// belong to one writer thread. flush(), wait_durable(), durable_seq() and
+/// capacity() are safe from any thread.
+class Journal
+{
+  public:
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    ~Journal() noexcept
+    {
+        m_flusher.request_stop();
+        if (m_flusher.joinable())
+            m_flusher.join();
+        (void)flush();
+        ::munmap(m_map, m_map_size);
+        ::close(m_fd);
+    }
+
+    /// @brief Creates (or truncates) a segment at `path` with room for
+    /// `capacity` events, numbered from `base_seq`.
+    static auto create(const std::string &path, sz_t capacity, u64_t base_seq = 1, JournalConfig config = {})
+        -> std::expected<std::unique_ptr<Journal>, FileError>
+    {
+        if (capacity == 0 || base_seq == 0)
+            return std::unexpected(FileError::BAD_HEADER);
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return std::unexpected(FileError::OPEN_FAIL);
+
+        const sz_t size = sizeof(JournalHeader) + capacity * sizeof(JournalRecord);
+        if (::posix_fallocate(fd, 0, static_cast<off_t>(size)) != 0)
+        {
+            ::close(fd);
+            return std::unexpected(FileError::WRITE_FAIL);
+        }
+        const JournalHeader header{.capacity = capacity, .base_seq = base_seq};
+        if (::pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+        {
+            ::close(fd);
+            return std::unexpected(FileError::WRITE_FAIL);
+        }
+        if (::fsync(fd) != 0)
+        {
+            ::close(fd);
+            return std::unexpected(FileError::SYNC_FAIL);
+        }
+        return _map(fd, size, header, 0, config);
+    }
+
+    /// @brief Reopens an existing segment and resumes appending after its
+    /// last valid record. A torn tail left by a crash is overwritten.
+    static auto open(const std::string &path, JournalConfig config = {})
+        -> std::expected<std::unique_ptr<Journal>, FileError>
+    {
+        const int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd < 0)
+            return std::unexpected(FileError::OPEN_FAIL);
+        struct stat st{};
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            return std::unexpected(FileError::STAT_FAIL);
+        }
+        const auto size = static_cast<sz_t>(st.st_size);
+        JournalHeader header{};
+        if (size < sizeof(header) || ::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+        {
+            ::close(fd);
+            return std::unexpected(FileError::BAD_HEADER);
+        }
+        if (auto checked = detail::check_journal_header(header, size); !checked)
+        {
+            ::close(fd);
+            return std::unexpected(checked.error());
+        }
+        return _map(fd, sizeof(header) + header.capacity * sizeof(JournalRecord), header, std::nullopt, config);
+    }
+
+    /// @brief Copies `event` into the next slot of the mapping. The record is
+    /// zeroed and filled field by field, so OrderEvent's padding reaches
+    /// neither the checksum nor the file as stack garbage.
+    /// @return Its sequence number, or 0 if the segment is full (checkpoint
+    /// and reset() to continue).
+    [[nodiscard, gnu::always_inline]]
+    u64_t append(const OrderEvent &event) noexcept
+    {
+        if (m_next == m_capacity) [[unlikely]]
+            return 0;
+        JournalRecord record{};
+        record.seq = m_base_seq + m_next;
+        record.event.id = event.id;
+        record.event.price = event.price;
+        record.event.qty = event.qty;
+        record.event.symbol = event.symbol;
+        record.event.type = event.type;
+        record.event.is_buy = event.is_buy;
+        record.event.order_type = event.order_type;
+        record.check = JournalRecord::checksum(record.seq, record.event);
+        std::memcpy(m_records + m_next, &record, sizeof(record));
+        m_written.store(++m_next, std::memory_order_release);
+        return record.seq;
+    }
+
+    /// @brief Synchronously makes every event appended so far durable.
+    auto flush() noexcept -> std::expected<void, FileError>
+    {
+        std::scoped_lock lock{m_sync_mutex};
+        return _sync_locked();
+    }
+
+    /// @brief Blocks until `seq` is durable, or until a sync attempt fails.
+    /// @return False if the latest sync attempt failed. A failure is not
+    /// sticky: nothing past the failed range is counted as durable, the next
+    /// pass (or flush()) retries that same range, and once one succeeds the
+    /// journal is healthy again, so calling again waits for that retry.
+    bool wait_durable(u64_t seq) const noexcept
+    {
+        while (m_durable_seq.load(std::memory_order_acquire) < seq)
+        {
+            if (m_failed.load(std::memory_order_relaxed))
+                return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    /// @brief Starts the segment over at `base_seq`, typically right after a
+    /// snapshot taken at `base_seq - 1` (see checkpoint()).
+    ///
+    /// Only the header is rewritten. Old slots can never pass validation
+    /// again because their seqs are below the new base, so nothing is zeroed.
+    auto reset(u64_t base_seq) noexcept -> std::expected<void, FileError>
+    {
+        std::scoped_lock lock{m_sync_mutex};
+        if (base_seq <= m_base_seq + m_next - 1)
+            return std::unexpected(FileError::SEQ_GAP);
+        if (auto synced = _sync_locked(); !synced)
+            return synced;
+
+        JournalHeader header;
+        std::memcpy(&header, m_map, sizeof(header));
+        header.base_seq = base_seq;
+        std::memcpy(m_map, &header, sizeof(header));
+        if (::msync(m_map, sizeof(header), MS_SYNC) != 0)
+            return std::unexpected(FileError::SYNC_FAIL);
+
+        m_base_seq = base_seq;
+        m_next = 0;
+        m_synced = 0;
+        m_written.store(0, std::memory_order_relaxed);
+        m_durable_seq.store(base_seq - 1, std::memory_order_release);
+        return {};
+    }
+
+    /// @return Sequence number of the last appended event (base_seq - 1 when
+    /// the segment is empty). Writer thread only; other threads track
+    /// progress through durable_seq().
+    [[nodiscard]] u64_t last_seq() const noexcept
+    {
+        return m_base_seq + m_next - 1;
+    }
+
+    [[nodiscard]] u64_t durable_seq() const noexcept
+    {
+        return m_durable_seq.load(std::memory_order_acquire);
+    }
+
+    /// @return Events appended since the segment's base. Writer thread only.
+    [[nodiscard]] sz_t size() const noexcept
+    {
+        return m_next;
+    }
+
+    [[nodiscard]] sz_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+  private:
+    int m_fd;
+    std::byte *m_map;
+    sz_t m_map_size;
+    JournalRecord *m_records;
+    sz_t m_capacity;
+    sz_t m_page_size;
+
+    // Writer state
+    u64_t m_base_seq;
+    sz_t m_next;
+
+    alignas(cacheline_t::value) std::atomic<sz_t> m_written{0}; // slots published by append()
+
+    // Flusher state, guarded by m_sync_mutex
+    alignas(cacheline_t::value) std::mutex m_sync_mutex;
+    std::condition_variable_any m_wake;
+    sz_t m_synced{0};
+    std::atomic<u64_t> m_durable_seq;
+    std::atomic<bool> m_failed{false}; // the latest sync attempt failed
+    std::jthread m_flusher{}; // declared last: stopped before the rest is torn down
+
+    Journal(int fd, std::byte *map, sz_t map_size, const JournalHeader &header, sz_t next) noexcept
+        : m_fd{fd}, m_map{map}, m_map_size{map_size},
+          m_records{reinterpret_cast<JournalRecord *>(map + sizeof(JournalHeader))}, m_capacity{header.capacity},
+          m_page_size{static_cast<sz_t>(::sysconf(_SC_PAGESIZE))}, m_base_seq{header.base_seq}, m_next{next},
+          m_written{next}, m_synced{next}, m_durable_seq{header.base_seq + next - 1}
+    {
+    }
+
+    /// @param next Slots already in use, or nullopt to find them by scanning.
+    static auto _map(int fd, sz_t size, const JournalHeader &header, std::optional<sz_t> next, JournalConfig config)
+        -> std::expected<std::unique_ptr<Journal>, FileError>
+    {
+        void *p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            ::close(fd);
+            return std::unexpected(FileError::MMAP_FAIL);
+        }
+        auto *map = static_cast<std::byte *>(p);
+        const sz_t used = next.value_or(detail::journal_valid_prefix(
+            {reinterpret_cast<const JournalRecord *>(map + sizeof(JournalHeader)), header.capacity}, header.base_seq));
+
+        std::unique_ptr<Journal> journal{new Journal{fd, map, size, header, used}};
+        Journal &j = *journal;
+        j.m_flusher = std::jthread{[&j, config](std::stop_token st) { j._run_flusher(config, st); }};
+        return journal;
+    }
+
+    void _run_flusher(JournalConfig config, std::stop_token st) noexcept
+    {
+        if (config.flusher_core >= 0)
+            (void)pin_this_thread(config.flusher_core);
+
+        std::unique_lock lock{m_sync_mutex};
+        while (!st.stop_requested())
+        {
+            // Sleeps the whole window unless stopped; nobody else notifies, so
+            // append() never pays for a wakeup
+            m_wake.wait_for(lock, st, config.flush_interval, [] { return false; });
+            (void)_sync_locked();
+        }
+    }
+
+    auto _sync_locked() noexcept -> std::expected<void, FileError>
+    {
+        const sz_t written = m_written.load(std::memory_order_acquire);
+        if (written <= m_synced)
+            return {};
+
+        const sz_t begin = sizeof(JournalHeader) + m_synced * sizeof(JournalRecord);
+        const sz_t end = sizeof(JournalHeader) + written * sizeof(JournalRecord);
+        const sz_t page_begin = begin & ~(m_page_size - 1);
+        // m_synced only moves on success, so a retry covers the failed range
+        if (::msync(m_map + page_begin, end - page_begin, MS_SYNC) != 0)
+        {
+            m_failed.store(true, std::memory_order_relaxed);
+            return std::unexpected(FileError::SYNC_FAIL);
+        }
+
+        m_failed.store(false, std::memory_order_relaxed);
+        m_synced = written;
+        m_durable_seq.store(m_base_seq + written - 1, std::memory_order_release);
+        return {};
+    }
+};
+
+/// @brief Read-only view of the valid prefix of a journal segment.
+class JournalReader
+{
+  public:
+    static auto open(const std::string &path) -> std::expected<JournalReader, FileError>
+    {
+        auto file = MappedFile::open(path, true);
+        if (!file)
+            return std::unexpected(file.error());
+        if (file->size() < sizeof(JournalHeader))
+            return std::unexpected(FileError::BAD_HEADER);
+        JournalHeader header;
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (auto checked = detail::check_journal_header(header, file->size()); !checked)
+            return std::unexpected(checked.error());
+
+        const std::span<const JournalRecord> slots{
+            reinterpret_cast<const JournalRecord *>(file->data() + sizeof(JournalHeader)), header.capacity};
+        const sz_t count = detail::journal_valid_prefix(slots, header.base_seq);
+        return JournalReader{std::move(*file), header.base_seq, count};
+    }
+
+    [[nodiscard]] std::span<const JournalRecord> records() const noexcept
+    {
+        return {reinterpret_cast<const JournalRecord *>(m_file.data() + sizeof(JournalHeader)), m_count};
+    }
+
+    [[nodiscard]] u64_t base_seq() const noexcept
+    {
+        return m_base_seq;
+    }
+
+  private:
+    MappedFile m_file;
+    u64_t m_base_seq;
+    sz_t m_count;
+
+    JournalReader(MappedFile file, u64_t base_seq, sz_t count) noexcept
+        : m_file{std::move(file)}, m_base_seq{base_seq}, m_count{count}
+    {
+    }
+};
+
+/// @brief Snapshots `book` at the journal's current position, then starts
+/// the journal over after it, from the journal's writer thread. A crash
+/// between the two steps is harmless: recovery skips journal records the
+/// snapshot already covers.
+template <class Book>
+auto checkpoint(const Book &book, Journal &journal, const std::string &snapshot_path)
+    -> std::expected<void, FileError>
+{
+    const u64_t seq = journal.last_seq();
+    if (auto saved = book.save_snapshot(snapshot_path, seq); !saved)
+        return saved;
+    return journal.reset(seq + 1);
+}
+
+/// @brief Applies every event in the journal at `journal_path` with a
+/// sequence number above `after_seq` to `book`. A missing journal means
+/// there is nothing to replay.
+/// @return SEQ_GAP if the journal starts past `after_seq + 1`, i.e. events
+/// in between are lost.
+template <class Book, TradeSink Sink>
+auto replay_journal(Book &book, const std::string &journal_path, u64_t after_seq, Sink &&sink)
+    -> std::expected<void, FileError>
+{
+    auto journal = JournalReader::open(journal_path);
+    if (!journal)
+    {
+        if (journal.error() == FileError::OPEN_FAIL)
+            return {};
+        return std::unexpected(journal.error());
+    }
+
+    const auto records = journal->records();
+    if (records.empty())
+        return {};
+    if (journal->base_seq() > after_seq + 1)
+        return std::unexpected(FileError::SEQ_GAP);
+    const auto skip = static_cast<sz_t>(std::min<u64_t>(after_seq + 1 - journal->base_seq(), records.size()));
+    for (const JournalRecord &record : records.subspan(skip))
+        apply_event(book, record.event, sink);
+    return {};
+}
+
+/// @brief Rebuilds a book after a restart: restores the latest snapshot (or
+/// starts empty if there is none) and replays every journaled event after
+/// it, handing replayed trades to `sink`.
+template <class Book, TradeSink Sink>
+auto recover_book(const std::string &snapshot_path, const std::string &journal_path, Sink &&sink)
+    -> std::expected<Book, FileError>
+{
+    u64_t snapshot_seq = 0;
+    auto book = Book::restore_snapshot(snapshot_path, &snapshot_seq);
+    if (!book && book.error() != FileError::OPEN_FAIL)
+        return book;
+    if (!book)
+    {
+        std::expected<Book, FileError> empty{std::in_place};
+        if (auto replayed = replay_journal(*empty, journal_path, 0, sink); !replayed)
+            return std::unexpected(replayed.error());
+        return empty;
+    }
+    if (auto replayed = replay_journal(*book, journal_path, snapshot_seq, sink); !replayed)
+        return std::unexpected(replayed.error());
+    return book;
+}
+
+template <class Book>
+auto recover_book(const std::string &snapshot_path, const std::string &journal_path) -> std::expected<Book, FileError>
+{
+    return recover_book<Book>(snapshot_path, journal_path, [](const Trade &) {});
+}
+
+} // End namespace fiah
@@ -0,0 +1,92 @@
+#pragma once
+
+// C++ Includes
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// FastInAHurry Includes
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+using SymbolId = u32_t;
+
+/// @brief Compact, trivially copyable order-entry message addressed to one
+/// instrument's book. The unit of work for everything that feeds books from
+/// another thread or from a file.
+struct OrderEvent
+{
+    enum class Type : u8_t
+    {
+        ADD,
+        CANCEL,
+        MODIFY
+    };
+
+    Id id;
+    Price price;
+    Quantity qty;
+    SymbolId symbol;
+    Type type;
+    bool is_buy;
+    Order::Type order_type; ///< ADD only
+
+    static OrderEvent add(SymbolId symbol, const Order &order) noexcept
+    {
+        return {order.get_id(), order.get_level(), order.get_qty(), symbol,
+                Type::ADD,      order.is_buy(),    order.get_type()};
+    }
+
+    static constexpr OrderEvent cancel(SymbolId symbol, Id id) noexcept
+    {
+        return {id, Price{}, Quantity{}, symbol, Type::CANCEL, false, Order::Type::LIMIT};
+    }
+
+    static constexpr OrderEvent modify(SymbolId symbol, Id id, Quantity new_qty, Price new_price) noexcept
+    {
+        return {id, new_price, new_qty, symbol, Type::MODIFY, false, Order::Type::LIMIT};
+    }
+};
+static_assert(sizeof(OrderEvent) == 32);
+static_assert(std::is_trivially_copyable_v<OrderEvent>);
+static_assert(std::is_standard_layout_v<OrderEvent>);
+
+/// @brief True when the enum and bool bytes of an event copied in from the
+/// wire or a file hold values apply_event() accepts. Reads the raw bytes, not
+/// the fields, so it is safe on whatever a peer or a corrupt file sent.
+[[nodiscard]] inline bool is_well_formed(const OrderEvent &event) noexcept
+{
+    const auto *raw = reinterpret_cast<const unsigned char *>(&event);
+    u8_t type, is_buy, order_type;
+    std::memcpy(&type, raw + offsetof(OrderEvent, type), 1);
+    std::memcpy(&is_buy, raw + offsetof(OrderEvent, is_buy), 1);
+    std::memcpy(&order_type, raw + offsetof(OrderEvent, order_type), 1);
+    return type <= std::to_underlying(OrderEvent::Type::MODIFY) && is_buy <= 1 &&
+           order_type <= std::to_underlying(Order::Type::FOK);
+}
+
+/// @brief Routes one event to the matching book entry point.
+template <class Book, TradeSink Sink> void apply_event(Book &book, const OrderEvent &event, Sink &&sink)
+{
+    switch (event.type)
+    {
+    case OrderEvent::Type::ADD:
+        book.AddOrder(Order{event.id, event.price, event.is_buy, event.qty, event.order_type}, sink);
+        return;
+    case OrderEvent::Type::CANCEL:
+        book.CancelOrder(event.id);
+        return;
+    case OrderEvent::Type::MODIFY:
+        book.ModifyOrder(event.id, event.qty, event.price, sink);
+        return;
+    default:
+        std::unreachable();
+    }
+}
+
+} // End namespace fiah
@@ -0,0 +1,493 @@
+#pragma once
+
+// C++ Includes
+#include <sys/socket.h>
+#include <x86intrin.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// FastInAHurry Includes
+#include "fiah/engine/OrderEvent.hh"
+#include "fiah/error/Error.hh"
+#include "fiah/io/Udp.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/thread/Affinity.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Monotonic nanoseconds shared by everything that stamps or
+/// measures wire messages in one process.
+[[gnu::always_inline]] inline u64_t wire_clock_ns() noexcept
+{
+    return static_cast<u64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+/// @brief Ingress datagram: one event, stamped by the sender.
+struct WireOrder
+{
+    u64_t sent_ns;
+    OrderEvent event;
+};
+static_assert(sizeof(WireOrder) == 40);
+static_assert(std::is_trivially_copyable_v<WireOrder>);
+
+/// @brief Egress datagram: one trade plus the send stamp of the order that
+/// caused it, so the receiver can measure wire to wire. Trade's fields are
+/// laid out flat with the tail padding spelled out, so no byte on the wire
+/// is left uninitialised.
+struct WireTrade
+{
+    u64_t origin_ns;
+    Id order_id_a;
+    Id order_id_b;
+    Id aggressor_order_id;
+    Price price;
+    Quantity size;
+    u8_t aggressor_is_buy;
+    u8_t pad[3];
+
+    static WireTrade from(u64_t origin_ns, const Trade &trade) noexcept
+    {
+        WireTrade msg{};
+        msg.origin_ns = origin_ns;
+        msg.order_id_a = trade.OrderIdA;
+        msg.order_id_b = trade.OrderIdB;
+        msg.aggressor_order_id = trade.AggressorOrderId;
+        msg.price = trade.Level;
+        msg.size = trade.Size;
+        msg.aggressor_is_buy = trade.AggressorIsBuy;
+        return msg;
+    }
+
+    Trade trade() const noexcept
+    {
+        return Trade{order_id_a, order_id_b, aggressor_order_id, aggressor_is_buy != 0, price, size};
+    }
+};
+static_assert(sizeof(WireTrade) == sizeof(u64_t) + 3 * sizeof(Id) + sizeof(Price) + sizeof(Quantity) +
+                                       sizeof(u8_t) + sizeof(WireTrade::pad));
+static_assert(std::has_unique_object_representations_v<WireTrade>);
+
+struct PipelineConfig
+{
+    std::string ingress_ip{"127.0.0.1"};
+    u16_t ingress_port{0}; ///< 0 binds an ephemeral port; see ingress_port()
+    std::string egress_ip{"127.0.0.1"};
+    u16_t egress_port{0}; ///< Where trades are sent
+    int rx_core{-1};      ///< Core per stage, pinned when non-negative
+    int book_core{-1};
+    int tx_core{-1};
+    int recv_buffer_bytes{4 << 20};
+    /// Stages spin on empty input when they own a core. Set this when they
+    /// share cores (CI, laptops) so idle stages give the CPU away instead.
+    bool yield_when_idle{false};
+};
+
+/// @brief Per-stage counters. Every field has exactly one writing stage.
+struct PipelineStats
+{
+    u64_t received{};      ///< Well-formed datagrams handed to the book
+    u64_t malformed{};     ///< Datagrams of the wrong size or with bad fields
+    u64_t ingress_drops{}; ///< Lost to a full ingress ring
+    u64_t applied{};       ///< Events the book has processed
+    u64_t trades{};
+    u64_t egress_drops{}; ///< Trades lost to a full egress ring
+    u64_t sent{};
+    u64_t send_errors{};
+};
+
+/// @brief Reference staged matching engine: UDP in, book, UDP out.
+///
+///     rx thread --SPSC--> book thread --SPSC--> tx thread
+///
+/// The rx stage busy-polls a non-blocking socket and pushes well-formed
+/// WireOrders onto the ingress ring. The book stage is the only thread that
+/// touches the book; it turns each trade into a WireTrade on the egress ring.
+/// The tx stage sends those to the configured peer. Each stage can be pinned
+/// to its own core and shares nothing with the others but the two rings and
+/// its own counters, which sit on separate cache lines.
+///
+/// stop() shuts the stages down front to back, and each one drains its input
+/// ring before exiting, so nothing already received is lost.
+///
+/// @tparam Book Any book apply_event() can drive.
+/// @tparam QUEUE_SIZE Capacity of each ring (power of two).
+template <class Book = LadderOrderbook, sz_t QUEUE_SIZE = (1 << 14)> class MatchingPipeline
+{
+  public:
+    MatchingPipeline(const MatchingPipeline &) = delete;
+    MatchingPipeline &operator=(const MatchingPipeline &) = delete;
+
+    ~MatchingPipeline() noexcept
+    {
+        stop();
+    }
+
+    /// @brief Binds both sockets and starts the three stages.
+    static auto start(Book book, PipelineConfig config) -> std::expected<std::unique_ptr<MatchingPipeline>, UdpError>
+    {
+        std::unique_ptr<MatchingPipeline> pipeline{new MatchingPipeline{std::move(book), config}};
+        MatchingPipeline &p = *pipeline;
+        if (auto started = p.m_ingress.start(); !started)
+            return std::unexpected(started.error());
+        (void)p.m_ingress.set_recv_buffer(config.recv_buffer_bytes);
+        if (auto started = p.m_egress.start(); !started)
+            return std::unexpected(started.error());
+
+        p.m_peer.sin_family = AF_INET;
+        p.m_peer.sin_port = ::htons(config.egress_port);
+        if (::inet_pton(AF_INET, config.egress_ip.c_str(), &p.m_peer.sin_addr) != 1)
+            return std::unexpected(UdpError::INVALID_IP);
+
+        p.m_tx = std::jthread{[&p](std::stop_token st) { p._run_tx(st); }};
+        p.m_book_thread = std::jthread{[&p](std::stop_token st) { p._run_book(st); }};
+        p.m_rx = std::jthread{[&p](std::stop_token st) { p._run_rx(st); }};
+        return pipeline;
+    }
+
+    /// @brief Stops and joins the stages, front to back. Idempotent.
+    void stop() noexcept
+    {
+        for (std::jthread *stage : {&m_rx, &m_book_thread, &m_tx})
+        {
+            stage->request_stop();
+            if (stage->joinable())
+                stage->join();
+        }
+    }
+
+    [[nodiscard]] u16_t ingress_port() const noexcept
+    {
+        return m_ingress.local_port();
+    }
+
+    /// @brief Counters as of now; fields may be from slightly different
+    /// instants while the stages run.
+    [[nodiscard]] PipelineStats stats() const noexcept
+    {
+        constexpr auto relaxed = std::memory_order_relaxed;
+        return {m_rx_counters.received.load(relaxed),  m_rx_counters.malformed.load(relaxed),
+                m_rx_counters.drops.load(relaxed),     m_book_counters.applied.load(relaxed),
+                m_book_counters.trades.load(relaxed),  m_book_counters.drops.load(relaxed),
+                m_tx_counters.sent.load(relaxed),      m_tx_counters.errors.load(relaxed)};
+    }
+
+    /// @attention Only safe after stop().
+    Book &book() noexcept
+    {
+        return m_book;
+    }
+
+  private:
+    using IngressQueue = SPSCQueue<WireOrder, QUEUE_SIZE>;
+    using EgressQueue = SPSCQueue<WireTrade, QUEUE_SIZE>;
+
+    struct alignas(cacheline_t::value) RxCounters
+    {
+        std::atomic<u64_t> received{0};
+        std::atomic<u64_t> malformed{0};
+        std::atomic<u64_t> drops{0};
+    };
+
+    struct alignas(cacheline_t::value) BookCounters
+    {
+        std::atomic<u64_t> applied{0};
+        std::atomic<u64_t> trades{0};
+        std::atomic<u64_t> drops{0};
+    };
+
+    struct alignas(cacheline_t::value) TxCounters
+    {
+        std::atomic<u64_t> sent{0};
+        std::atomic<u64_t> errors{0};
+    };
+
+    PipelineConfig m_config;
+    Book m_book;
+    UdpServer m_ingress;
+    UdpServer m_egress;
+    sockaddr_in m_peer{};
+    std::unique_ptr<IngressQueue> m_in{std::make_unique<IngressQueue>()};
+    std::unique_ptr<EgressQueue> m_out{std::make_unique<EgressQueue>()};
+    RxCounters m_rx_counters;
+    BookCounters m_book_counters;
+    TxCounters m_tx_counters;
+    // Declared last: joined before anything they use is torn down
+    std::jthread m_tx{};
+    std::jthread m_book_thread{};
+    std::jthread m_rx{};
+
+    MatchingPipeline(Book book, PipelineConfig config)
+        : m_config{std::move(config)}, m_book{std::move(book)}, m_ingress{m_config.ingress_ip, m_config.ingress_port},
+          m_egress{"0.0.0.0", 0}
+    {
+    }
+
+    /// Single writer per counter: a plain increment is enough to publish it
+    static void _bump(std::atomic<u64_t> &counter) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void _idle() const noexcept
+    {
+        if (m_config.yield_when_idle)
+            std::this_thread::yield();
+        else
+            _mm_pause();
+    }
+
+    void _run_rx(std::stop_token st) noexcept
+    {
+        if (m_config.rx_core >= 0)
+            (void)pin_this_thread(m_config.rx_core);
+
+        // One byte of slack so an oversized datagram shows up as the wrong size
+        alignas(WireOrder) std::byte buf[sizeof(WireOrder) + 1];
+        sockaddr_in peer{};
+        while (!st.stop_requested())
+        {
+            const ssize_t n = m_ingress.recv(buf, sizeof(buf), peer, MSG_DONTWAIT);
+            if (n < 0)
+            {
+                _idle();
+                continue;
+            }
+            if (static_cast<sz_t>(n) != sizeof(WireOrder)) [[unlikely]]
+            {
+                _bump(m_rx_counters.malformed);
+                continue;
+            }
+            WireOrder msg;
+            std::memcpy(&msg, buf, sizeof(msg));
+            if (!is_well_formed(msg.event)) [[unlikely]]
+            {
+                _bump(m_rx_counters.malformed);
+                continue;
+            }
+            if (!m_in->push(msg)) [[unlikely]]
+            {
+                _bump(m_rx_counters.drops);
+                continue;
+            }
+            _bump(m_rx_counters.received);
+        }
+    }
+
+    void _run_book(std::stop_token st) noexcept
+    {
+        if (m_config.book_core >= 0)
+            (void)pin_this_thread(m_config.book_core);
+
+        WireOrder msg;
+        auto on_trade = [this, &msg](const Trade &trade) {
+            _bump(m_book_counters.trades);
+            if (!m_out->push(WireTrade::from(msg.sent_ns, trade))) [[unlikely]]
+                _bump(m_book_counters.drops);
+        };
+        auto apply = [&] {
+            apply_event(m_book, msg.event, on_trade);
+            _bump(m_book_counters.applied);
+        };
+
+        while (!st.stop_requested())
+        {
+            if (m_in->pop(msg))
+                apply();
+            else
+                _idle();
+        }
+        while (m_in->pop(msg))
+            apply();
+    }
+
+    void _run_tx(std::stop_token st) noexcept
+    {
+        if (m_config.tx_core >= 0)
+            (void)pin_this_thread(m_config.tx_core);
+
+        WireTrade msg;
+        auto send = [&] {
+            if (m_egress.send(&msg, sizeof(msg), m_peer) == static_cast<ssize_t>(sizeof(msg)))
+                _bump(m_tx_counters.sent);
+            else
+                _bump(m_tx_counters.errors);
+        };
+
+        while (!st.stop_requested())
+        {
+            if (m_out->pop(msg))
+                send();
+            else
+                _idle();
+        }
+        while (m_out->pop(msg))
+            send();
+    }
+};
+
+struct LoadConfig
+{
+    std::string target_ip{"127.0.0.1"}; ///< Pipeline ingress address
+    u16_t listen_port{0}; ///< Where trades come back; 0 binds an ephemeral port
+    u64_t rate{100'000};  ///< Events per second; 0 sends flat out
+    std::chrono::milliseconds drain_timeout{200}; ///< Quiet time that ends a run
+    int send_core{-1};
+    int recv_core{-1};
+    bool yield_when_idle{false};
+};
+
+/// @brief Outcome of LoadGenerator::run(). Latencies are wire to wire: from
+/// just before an order is sent to just after each trade it caused arrives.
+struct LoadReport
+{
+    u64_t sent{};
+    u64_t send_errors{};
+    u64_t trades_received{};
+    u64_t elapsed_ns{};
+    u64_t p50_ns{};
+    u64_t p90_ns{};
+    u64_t p99_ns{};
+    u64_t p999_ns{};
+    u64_t max_ns{};
+};
+
+/// @brief Loopback load generator for MatchingPipeline: paces WireOrders at
+/// the pipeline's ingress and times the WireTrades that come back.
+class LoadGenerator
+{
+  public:
+    static auto create(LoadConfig config) -> std::expected<LoadGenerator, UdpError>
+    {
+        LoadGenerator gen{std::move(config)};
+        if (auto started = gen.m_listener.start(); !started)
+            return std::unexpected(started.error());
+        (void)gen.m_listener.set_recv_buffer(4 << 20);
+        return gen;
+    }
+
+    /// @return Port trades should be sent to (the pipeline's egress_port).
+    [[nodiscard]] u16_t listen_port() const noexcept
+    {
+        return m_listener.local_port();
+    }
+
+    /// @brief Sends every event once from a sender thread to `target_port`,
+    /// then waits for trades until none has arrived for `drain_timeout`.
+    LoadReport run(u16_t target_port, std::span<const OrderEvent> events)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::vector<u64_t> latencies;
+        latencies.reserve(events.size());
+        std::atomic<u64_t> received{0};
+        std::jthread receiver{[&](std::stop_token st) {
+            if (m_config.recv_core >= 0)
+                (void)pin_this_thread(m_config.recv_core);
+            WireTrade msg;
+            sockaddr_in peer{};
+            while (!st.stop_requested())
+            {
+                if (m_listener.recv(&msg, sizeof(msg), peer, MSG_DONTWAIT) != static_cast<ssize_t>(sizeof(msg)))
+                {
+                    _idle();
+                    continue;
+                }
+                latencies.push_back(wire_clock_ns() - msg.origin_ns);
+                received.store(received.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+        }};
+
+        LoadReport report;
+        const auto start = Clock::now();
+        std::jthread{[&] {
+            if (m_config.send_core >= 0)
+                (void)pin_this_thread(m_config.send_core);
+            UdpClient client{m_config.target_ip, target_port};
+            const double gap_ns = m_config.rate ? 1e9 / static_cast<double>(m_config.rate) : 0.0;
+            for (sz_t i = 0; i < events.size(); ++i)
+            {
+                if (gap_ns > 0.0)
+                {
+                    const auto due =
+                        start + std::chrono::nanoseconds{static_cast<i64_t>(gap_ns * static_cast<double>(i))};
+                    while (Clock::now() < due)
+                        _idle();
+                }
+                const WireOrder msg{wire_clock_ns(), events[i]};
+                if (client.send(&msg, sizeof(msg)) == static_cast<ssize_t>(sizeof(msg)))
+                    ++report.sent;
+                else
+                    ++report.send_errors;
+            }
+        }}.join();
+
+        u64_t seen = received.load(std::memory_order_acquire);
+        auto quiet_since = Clock::now();
+        while (Clock::now() - quiet_since < m_config.drain_timeout)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            if (const u64_t now = received.load(std::memory_order_acquire); now != seen)
+            {
+                seen = now;
+                quiet_since = Clock::now();
+            }
+        }
+        receiver.request_stop();
+        receiver.join();
+
+        report.elapsed_ns = static_cast<u64_t>(std::chrono::nanoseconds{Clock::now() - start}.count());
+        report.trades_received = latencies.size();
+        if (latencies.empty())
+            return report;
+
+        auto percentile = [&latencies](double q) {
+            const auto rank = static_cast<sz_t>(q * static_cast<double>(latencies.size() - 1));
+            std::nth_element(latencies.begin(), latencies.begin() + static_cast<std::ptrdiff_t>(rank), latencies.end());
+            return latencies[rank];
+        };
+        report.p50_ns = percentile(0.50);
+        report.p90_ns = percentile(0.90);
+        report.p99_ns = percentile(0.99);
+        report.p999_ns = percentile(0.999);
+        report.max_ns = percentile(1.0);
+        return report;
+    }
+
+  private:
+    LoadConfig m_config;
+    UdpServer m_listener;
+
+    explicit LoadGenerator(LoadConfig config)
+        : m_config{std::move(config)}, m_listener{"127.0.0.1", m_config.listen_port}
+    {
+    }
+
+    void _idle() const noexcept
+    {
+        if (m_config.yield_when_idle)
+            std::this_thread::yield();
+        else
+            _mm_pause();
+    }
+};
+
+} // End namespace fiah
@@ -0,0 +1,194 @@
+#pragma once
+
+// C++ Includes
+#include <array>
+#include <bit>
+#include <cstdlib>
+#include <expected>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// FastInAHurry Includes
+#include "fiah/error/Error.hh"
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+using AccountId = u16_t;
+
+/// @brief Per-account pre-trade limits. Zero rate_window_ns disables the rate
+/// check; the other limits are always applied.
+struct RiskLimits
+{
+    Quantity max_order_qty{std::numeric_limits<Quantity>::max()};
+    i64_t max_order_notional{std::numeric_limits<i64_t>::max()}; ///< price * qty of one order
+    i64_t max_position{std::numeric_limits<i64_t>::max()};       ///< |net filled qty| after a full fill
+    u32_t max_orders_per_window{std::numeric_limits<u32_t>::max()};
+    u64_t rate_window_ns{0};
+};
+
+/// @brief One account's limits and running state, alone on its cache line so
+/// a check touches exactly one line.
+struct alignas(cacheline_t::value) AccountState
+{
+    RiskLimits limits{};
+    i64_t position{0}; ///< Net filled quantity, buys positive
+    u64_t window_start{0};
+    u32_t window_orders{0};
+    bool enabled{false};
+};
+static_assert(sizeof(AccountState) == cacheline_t::value);
+
+/// @brief Pre-trade risk stage for the thread that owns the books: order size,
+/// notional, worst-case position and order-rate limits per account.
+///
+/// Accounts are small dense ids indexing a flat array of AccountState, so a
+/// check is one bounds test, one cache line and straight-line arithmetic: the
+/// individual limits are folded into a bitmask with no branch each, and only
+/// a rejection takes the (unlikely) branch out. Nothing allocates after
+/// construction.
+///
+/// The position check assumes the order fills completely, against filled
+/// position only: working orders are not reserved. A market order's notional
+/// uses its level, so callers set that to their collar price.
+///
+/// @attention Not thread-safe; call from the book thread.
+class RiskGate
+{
+  public:
+    explicit RiskGate(sz_t num_accounts) : m_accounts(num_accounts)
+    {
+    }
+
+    RiskGate(const RiskGate &) = delete;
+    RiskGate &operator=(const RiskGate &) = delete;
+
+    sz_t num_accounts() const noexcept
+    {
+        return m_accounts.size();
+    }
+
+    /// @brief Sets `account`'s limits and enables it; its position and rate
+    /// window are kept.
+    /// @return False if the id is out of range.
+    bool set_limits(AccountId account, const RiskLimits &limits) noexcept
+    {
+        if (account >= m_accounts.size())
+            return false;
+        m_accounts[account].limits = limits;
+        m_accounts[account].enabled = true;
+        return true;
+    }
+
+    /// @brief Kill switch: a disabled account fails every check.
+    void set_enabled(AccountId account, bool enabled) noexcept
+    {
+        if (account < m_accounts.size())
+            m_accounts[account].enabled = enabled;
+    }
+
+    /// @brief Checks one new order and, if it passes, counts it against the
+    /// account's rate window.
+    /// @param now_ns Caller's clock, in the units of rate_window_ns.
+    /// @param market A market order's price is its collar, which may be
+    /// unset; any other order needs a positive price.
+    [[gnu::always_inline]]
+    std::expected<void, RiskError> check(AccountId account, bool is_buy, Quantity qty, Price price,
+                                         u64_t now_ns, bool market = false) noexcept
+    {
+        if (account >= m_accounts.size()) [[unlikely]]
+            return _reject(RiskError::UNKNOWN_ACCOUNT);
+
+        AccountState &state = m_accounts[account];
+        const RiskLimits &limits = state.limits;
+        const i64_t size = qty;
+        // An overflowing notional is a failure, never a wrapped-around pass
+        i64_t notional;
+        const bool notional_overflow = __builtin_mul_overflow(size, price, &notional);
+        const i64_t next_position = state.position + (is_buy ? size : -size);
+        const bool roll = now_ns - state.window_start >= limits.rate_window_ns;
+        const u32_t in_window = roll ? 0 : state.window_orders;
+
+        // Bit i is RiskError i
+        const u32_t fails = _bit(!state.enabled, RiskError::DISABLED) |
+                            _bit(qty <= 0 || qty > limits.max_order_qty, RiskError::ORDER_QTY) |
+                            _bit(!market && price <= 0, RiskError::PRICE) |
+                            _bit(notional_overflow || notional > limits.max_order_notional, RiskError::NOTIONAL) |
+                            _bit(std::abs(next_position) > limits.max_position, RiskError::POSITION) |
+                            _bit(in_window >= limits.max_orders_per_window, RiskError::RATE);
+        if (fails) [[unlikely]]
+            return _reject(static_cast<RiskError>(std::countr_zero(fails)));
+
+        state.window_start = roll ? now_ns : state.window_start;
+        state.window_orders = in_window + 1;
+        ++m_accepted;
+        return {};
+    }
+
+    [[gnu::always_inline]]
+    std::expected<void, RiskError> check(AccountId account, const Order &order, u64_t now_ns) noexcept
+    {
+        return check(account, order.is_buy(), order.get_qty(), order.get_level(), now_ns, order.is_market());
+    }
+
+    /// @brief Books a fill against `account`'s position.
+    void on_fill(AccountId account, bool is_buy, Quantity qty) noexcept
+    {
+        if (account < m_accounts.size())
+            m_accounts[account].position += is_buy ? qty : -i64_t{qty};
+    }
+
+    /// @brief Risk-checks `order` and, if it passes, sends it to `book`. The
+    /// account's position follows the fills this order takes as aggressor;
+    /// fills of its resting remainder are reported by the caller through
+    /// on_fill(), since only the caller knows which account owns a resting id.
+    template <class Book, TradeSink Sink>
+    std::expected<void, RiskError> add_order(Book &book, AccountId account, const Order &order, u64_t now_ns,
+                                             Sink &&sink)
+    {
+        if (auto ok = check(account, order, now_ns); !ok) [[unlikely]]
+            return ok;
+        book.AddOrder(order, [this, account, &sink](const Trade &trade) {
+            on_fill(account, trade.AggressorIsBuy, trade.Size);
+            sink(trade);
+        });
+        return {};
+    }
+
+    const AccountState &account(AccountId account) const noexcept
+    {
+        return m_accounts[account];
+    }
+
+    u64_t accepted() const noexcept
+    {
+        return m_accepted;
+    }
+
+    u64_t rejected(RiskError reason) const noexcept
+    {
+        return m_rejected[std::to_underlying(reason)];
+    }
+
+  private:
+    static constexpr u32_t _bit(bool failed, RiskError reason) noexcept
+    {
+        return static_cast<u32_t>(failed) << std::to_underlying(reason);
+    }
+
+    [[gnu::cold]] std::unexpected<RiskError> _reject(RiskError reason) noexcept
+    {
+        ++m_rejected[std::to_underlying(reason)];
+        return std::unexpected(reason);
+    }
+
+    std::vector<AccountState> m_accounts;
+    u64_t m_accepted{0};
+    std::array<u64_t, std::to_underlying(RiskError::COUNT)> m_rejected{};
+};
+
+} // End namespace fiah
@@ -47,4 +47,30 @@ enum class UdpError : std::uint8_t
     RECV_FAIL,
     INVALID_IP
 };
+
+enum class FileError : std::uint8_t
+{
+    OPEN_FAIL,
+    STAT_FAIL,
+    MMAP_FAIL,
+    WRITE_FAIL,
+    SYNC_FAIL,
+    BAD_HEADER,
+    TRUNCATED,
+    SEQ_GAP,
+    BAD_RECORD
+};
+
+/// Pre-trade risk rejections, in the order RiskGate checks them.
+enum class RiskError : std::uint8_t
+{
+    UNKNOWN_ACCOUNT,
+    DISABLED,
+    ORDER_QTY,
+    PRICE,
+    NOTIONAL,
+    POSITION,
+    RATE,
+    COUNT
+};
 } // namespace fiah
\ No newline at end of file
@@ -0,0 +1,196 @@
+#pragma once
+
+// C++ Includes
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// FastInAHurry Includes
+#include "fiah/error/Error.hh"
+#include "fiah/io/MappedFile.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Location of one array inside an image: byte offset from the start
+/// of the file and element count. Offsets instead of pointers are what makes
+/// an image position independent.
+struct ImageSection
+{
+    u64_t offset{0};
+    u64_t count{0};
+};
+
+/// @brief Builds a binary image on disk: a fixed header at offset 0 followed
+/// by cache-line aligned sections of trivially copyable elements.
+///
+/// Everything goes to `<path>.tmp` first; commit() writes the header, fsyncs
+/// and renames over `path`, so a crash never leaves a half-written image
+/// under the real name. The directory is fsynced after the rename, so once
+/// commit() returns the new name survives a crash too.
+class ImageWriter
+{
+  public:
+    static constexpr sz_t SECTION_ALIGN{64};
+
+    ImageWriter(const ImageWriter &) = delete;
+    ImageWriter &operator=(const ImageWriter &) = delete;
+
+    ImageWriter(ImageWriter &&other) noexcept
+        : m_path{std::move(other.m_path)}, m_fd{std::exchange(other.m_fd, -1)},
+          m_offset{other.m_offset}, m_header_size{other.m_header_size}
+    {
+    }
+
+    ImageWriter &operator=(ImageWriter &&) = delete;
+
+    ~ImageWriter() noexcept
+    {
+        if (m_fd >= 0)
+        {
+            ::close(m_fd);
+            ::unlink(_tmp_path().c_str());
+        }
+    }
+
+    /// @param header_size Bytes reserved at offset 0 for commit()'s header.
+    static auto create(std::string path, sz_t header_size) -> std::expected<ImageWriter, FileError>
+    {
+        ImageWriter writer{std::move(path), header_size};
+        writer.m_fd = ::open(writer._tmp_path().c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (writer.m_fd < 0)
+            return std::unexpected(FileError::OPEN_FAIL);
+        return writer;
+    }
+
+    /// @return Where `items` landed in the image.
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto append(std::span<const T> items) -> std::expected<ImageSection, FileError>
+    {
+        const u64_t offset = (m_offset + SECTION_ALIGN - 1) & ~u64_t{SECTION_ALIGN - 1};
+        if (!_pwrite_all(items.data(), items.size_bytes(), offset))
+            return std::unexpected(FileError::WRITE_FAIL);
+        m_offset = offset + items.size_bytes();
+        return ImageSection{offset, items.size()};
+    }
+
+    /// @brief Writes `header` at offset 0, makes the image durable and
+    /// publishes it under the final path.
+    template <class Header>
+        requires std::is_trivially_copyable_v<Header>
+    auto commit(const Header &header) -> std::expected<void, FileError>
+    {
+        if (sizeof(Header) > m_header_size || !_pwrite_all(&header, sizeof(header), 0))
+            return std::unexpected(FileError::WRITE_FAIL);
+        if (::fsync(m_fd) != 0)
+            return std::unexpected(FileError::SYNC_FAIL);
+        ::close(std::exchange(m_fd, -1));
+        if (std::rename(_tmp_path().c_str(), m_path.c_str()) != 0)
+            return std::unexpected(FileError::WRITE_FAIL);
+        if (!_sync_dir())
+            return std::unexpected(FileError::SYNC_FAIL);
+        return {};
+    }
+
+  private:
+    std::string m_path;
+    int m_fd{-1};
+    u64_t m_offset;
+    sz_t m_header_size;
+
+    ImageWriter(std::string path, sz_t header_size) noexcept
+        : m_path{std::move(path)}, m_offset{header_size}, m_header_size{header_size}
+    {
+    }
+
+    std::string _tmp_path() const
+    {
+        return m_path + ".tmp";
+    }
+
+    // The rename lives in the directory, not in the file: without this a
+    // crash can bring back the previous image, or none
+    bool _sync_dir() const noexcept
+    {
+        const std::filesystem::path dir = std::filesystem::path{m_path}.parent_path();
+        const int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        const bool ok = ::fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+    }
+
+    bool _pwrite_all(const void *buf, sz_t len, u64_t offset) const noexcept
+    {
+        const auto *p = static_cast<const char *>(buf);
+        while (len > 0)
+        {
+            const ssize_t n = ::pwrite(m_fd, p, len, static_cast<off_t>(offset));
+            if (n <= 0)
+                return false;
+            p += n;
+            len -= static_cast<sz_t>(n);
+            offset += static_cast<u64_t>(n);
+        }
+        return true;
+    }
+};
+
+/// @brief Read side of ImageWriter: maps the file and hands out typed,
+/// bounds-checked views of its sections without copying them.
+class ImageReader
+{
+  public:
+    static auto open(const std::string &path) -> std::expected<ImageReader, FileError>
+    {
+        auto file = MappedFile::open(path, true);
+        if (!file)
+            return std::unexpected(file.error());
+        return ImageReader{std::move(*file)};
+    }
+
+    template <class Header>
+        requires std::is_trivially_copyable_v<Header>
+    auto header() const -> std::expected<Header, FileError>
+    {
+        if (m_file.size() < sizeof(Header))
+            return std::unexpected(FileError::BAD_HEADER);
+        Header header;
+        std::memcpy(&header, m_file.data(), sizeof(header));
+        return header;
+    }
+
+    template <class T>
+        requires std::is_trivially_copyable_v<T>
+    auto section(ImageSection where) const -> std::expected<std::span<const T>, FileError>
+    {
+        // An empty trailing section may point past the end of the file
+        if (where.count == 0)
+            return std::span<const T>{};
+        if (where.offset % alignof(T) != 0 || where.offset > m_file.size() ||
+            where.count > (m_file.size() - where.offset) / sizeof(T))
+            return std::unexpected(FileError::TRUNCATED);
+        return std::span<const T>{reinterpret_cast<const T *>(m_file.data() + where.offset), where.count};
+    }
+
+  private:
+    MappedFile m_file;
+
+    explicit ImageReader(MappedFile file) noexcept : m_file{std::move(file)}
+    {
+    }
+};
+
+} // End namespace fiah
@@ -0,0 +1,115 @@
+#pragma once
+
+// C++ Includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <string>
+#include <utility>
+
+// FastInAHurry Includes
+#include "fiah/error/Error.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Read-only, move-only mapping of a whole file.
+///
+/// The pages are mapped MAP_PRIVATE and advised for sequential access, so
+/// streaming readers get kernel read-ahead without copying through a buffer.
+class MappedFile
+{
+  public:
+    MappedFile() noexcept = default;
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept
+        : m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0)}
+    {
+    }
+
+    MappedFile &operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            _unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() noexcept
+    {
+        _unmap();
+    }
+
+    /// @param populate Pre-fault every page (MAP_POPULATE) so the first pass
+    /// over the data does not take page faults.
+    static auto open(const std::string &path, bool populate = false) -> std::expected<MappedFile, FileError>
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return std::unexpected(FileError::OPEN_FAIL);
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            return std::unexpected(FileError::STAT_FAIL);
+        }
+
+        MappedFile file;
+        file.m_size = static_cast<sz_t>(st.st_size);
+        if (file.m_size > 0)
+        {
+            void *p = ::mmap(nullptr, file.m_size, PROT_READ, MAP_PRIVATE | (populate ? MAP_POPULATE : 0), fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::close(fd);
+                return std::unexpected(FileError::MMAP_FAIL);
+            }
+            ::madvise(p, file.m_size, MADV_SEQUENTIAL);
+            file.m_data = static_cast<const std::byte *>(p);
+        }
+        ::close(fd); // the mapping keeps the file alive
+        return file;
+    }
+
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept
+    {
+        return {m_data, m_size};
+    }
+
+    [[nodiscard]] const std::byte *data() const noexcept
+    {
+        return m_data;
+    }
+
+    [[nodiscard]] sz_t size() const noexcept
+    {
+        return m_size;
+    }
+
+  private:
+    const std::byte *m_data{nullptr};
+    sz_t m_size{0};
+
+    void _unmap() noexcept
+    {
+        if (m_data)
+            ::munmap(const_cast<std::byte *>(m_data), m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+};
+
+} // End namespace fiah
@@ -93,10 +93,31 @@ class UdpServer : private UdpBase
         return UdpBase::send(buf, len, peer);
     }
 
+    /// @param flags e.g. MSG_DONTWAIT for a busy-polling receiver.
     [[nodiscard, gnu::always_inline]] 
-    auto recv(void* buf, size_t len, sockaddr_in& peer) -> ssize_t
+    auto recv(void* buf, size_t len, sockaddr_in& peer, int flags = 0) -> ssize_t
     {
-        return UdpBase::recv(buf, len, peer);
+        return UdpBase::recv(buf, len, peer, flags);
+    }
+
+    /// @return The bound port; useful after binding port 0. Zero if not
+    /// started.
+    std::uint16_t local_port() const noexcept
+    {
+        sockaddr_in addr{};
+        socklen_t len = sizeof(addr);
+        if (!m_started || ::getsockname(get_fd(), reinterpret_cast<sockaddr*>(&addr), &len) < 0)
+            return 0;
+        return ::ntohs(addr.sin_port);
+    }
+
+    /// @brief Sets SO_RCVBUF so bursts queue in the kernel instead of being
+    /// dropped. Call after start().
+    auto set_recv_buffer(int bytes) -> std::expected<void, UdpError>
+    {
+        if (::setsockopt(get_fd(), SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes)) < 0)
+            return std::unexpected(UdpError::BAD_SOCKET);
+        return {};
     }
 
 private:
@@ -143,6 +164,13 @@ class UdpClient : private UdpBase
         return {};
     }
 
+    /// @brief Sends one datagram to the peer given at construction.
+    [[nodiscard, gnu::always_inline]]
+    auto send(const void* buf, size_t len) -> ssize_t
+    {
+        return UdpBase::send(buf, len, m_peer);
+    }
+
     [[nodiscard, gnu::always_inline]]
     auto recv(void* buf, size_t len, sockaddr_in& peer) -> ssize_t
     {
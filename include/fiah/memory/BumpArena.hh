@@ -28,7 +28,7 @@ private:
     std::byte* m_end;
 };
 
-BumpArena::BumpArena(void* buff, sz_t size) noexcept
+inline BumpArena::BumpArena(void* buff, sz_t size) noexcept
     : m_begin{static_cast<std::byte*>(buff)},
       m_curr{m_begin},
       m_end{m_begin + size}
@@ -36,7 +36,7 @@ BumpArena::BumpArena(void* buff, sz_t size) noexcept
 }
 
 [[nodiscard]]
-void* BumpArena::allocate(sz_t size, sz_t alignment) noexcept
+inline void* BumpArena::allocate(sz_t size, sz_t alignment) noexcept
 {
     void* ptr = m_curr;
     sz_t space = remaining();
@@ -50,22 +50,22 @@ void* BumpArena::allocate(sz_t size, sz_t alignment) noexcept
     return aligned;
 }
 
-sz_t BumpArena::used() noexcept
+inline sz_t BumpArena::used() noexcept
 {
     return static_cast<sz_t>(m_curr - m_begin);
 }
 
-sz_t BumpArena::remaining() noexcept
+inline sz_t BumpArena::remaining() noexcept
 {
     return static_cast<sz_t>(m_end - m_curr);
 }
 
-bool BumpArena::full() noexcept
+inline bool BumpArena::full() noexcept
 {
     return m_curr == m_end;
 }
 
-void BumpArena::reset() noexcept
+inline void BumpArena::reset() noexcept
 {
     m_curr = m_begin;
 }
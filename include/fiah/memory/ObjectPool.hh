@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "fiah/utils/Types.hh"
+#include "fiah/memory/BumpArena.hh"
+
+namespace fiah
+{
+
+/// @brief Fixed-capacity object pool with an intrusive free list.
+///
+/// One slab is allocated up front. Fresh slots are carved from it by a
+/// BumpArena, so pages are only touched as the pool warms up; released slots
+/// are threaded onto a LIFO free list and handed out again first. Once warm,
+/// create()/destroy() never reach the heap.
+///
+/// @attention Objects still alive when the pool dies are not destroyed; the
+/// owner must destroy() them (or T must be trivially destructible).
+/// @tparam T Pooled type.
+template <class T>
+class ObjectPool
+{
+public:
+    explicit ObjectPool(sz_t capacity);
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+    ObjectPool(ObjectPool&& other) noexcept;
+    ObjectPool& operator=(ObjectPool&&) = delete;
+    ~ObjectPool() noexcept;
+
+    /// @return Newly constructed object, or nullptr if the pool is exhausted.
+    template <class... Args>
+    [[nodiscard]] T* create(Args&&... args) noexcept;
+
+    void destroy(T* p) noexcept;
+
+    sz_t capacity() const noexcept;
+    sz_t in_use() const noexcept;
+    bool full() const noexcept;
+
+private:
+    union Slot
+    {
+        Slot* next_free;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    static constexpr std::align_val_t SLOT_ALIGN{alignof(Slot)};
+
+    std::byte* m_slab;
+    BumpArena m_arena;
+    Slot* m_free_head{nullptr};
+    sz_t m_capacity;
+    sz_t m_in_use{0};
+};
+
+template <class T>
+ObjectPool<T>::ObjectPool(sz_t capacity)
+    : m_slab{static_cast<std::byte*>(::operator new(std::max(capacity, sz_t{1}) * sizeof(Slot), SLOT_ALIGN))},
+      m_arena{m_slab, capacity * sizeof(Slot)},
+      m_capacity{capacity}
+{
+}
+
+template <class T>
+ObjectPool<T>::ObjectPool(ObjectPool&& other) noexcept
+    : m_slab{std::exchange(other.m_slab, nullptr)},
+      m_arena{std::exchange(other.m_arena, BumpArena{nullptr, 0})},
+      m_free_head{std::exchange(other.m_free_head, nullptr)},
+      m_capacity{std::exchange(other.m_capacity, 0)},
+      m_in_use{std::exchange(other.m_in_use, 0)}
+{
+}
+
+template <class T>
+ObjectPool<T>::~ObjectPool() noexcept
+{
+    ::operator delete(m_slab, SLOT_ALIGN);
+}
+
+template <class T>
+    template <class... Args>
+[[gnu::always_inline]]
+inline T* ObjectPool<T>::create(Args&&... args) noexcept
+{
+    void* mem;
+    if (m_free_head)
+    {
+        mem = std::exchange(m_free_head, m_free_head->next_free);
+    }
+    else
+    {
+        mem = m_arena.allocate(sizeof(Slot), alignof(Slot));
+        if (!mem) [[unlikely]]
+            return nullptr;
+    }
+    ++m_in_use;
+    return std::construct_at(static_cast<T*>(mem), std::forward<Args>(args)...);
+}
+
+template <class T>
+[[gnu::always_inline]]
+inline void ObjectPool<T>::destroy(T* p) noexcept
+{
+    std::destroy_at(p);
+    Slot* slot = reinterpret_cast<Slot*>(p);
+    slot->next_free = m_free_head;
+    m_free_head = slot;
+    --m_in_use;
+}
+
+template <class T>
+sz_t ObjectPool<T>::capacity() const noexcept
+{
+    return m_capacity;
+}
+
+template <class T>
+sz_t ObjectPool<T>::in_use() const noexcept
+{
+    return m_in_use;
+}
+
+template <class T>
+bool ObjectPool<T>::full() const noexcept
+{
+    return m_in_use == m_capacity;
+}
+
+} // End namespace fiah
@@ -0,0 +1,151 @@
+#pragma once
+
+// C++ Includes
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <expected>
+#include <utility>
+
+// FastInAHurry Includes
+#include "fiah/error/Error.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// How a PageMapping is backed, in order of preference.
+enum class PageMode : u8_t
+{
+    DEFAULT,          ///< Base pages
+    TRANSPARENT_HUGE, ///< Base-page mapping advised MADV_HUGEPAGE; the kernel may back it with 2 MiB pages
+    HUGETLB,          ///< Explicit 2 MiB pages from the hugetlbfs pool (MAP_HUGETLB)
+};
+
+struct PageConfig
+{
+    /// HUGETLB falls back to TRANSPARENT_HUGE when the pool is empty; mode()
+    /// reports what was actually mapped.
+    PageMode pages{PageMode::TRANSPARENT_HUGE};
+    /// Write one byte per page up front so the hot path never takes a first
+    /// touch fault.
+    bool prefault{true};
+};
+
+/// @brief Move-only, private anonymous read-write mapping, for large buffers
+/// that should live on huge pages and be resident before they are used.
+class PageMapping
+{
+  public:
+    static constexpr sz_t HUGE_PAGE_SIZE{sz_t{2} << 20};
+
+    PageMapping() noexcept = default;
+
+    PageMapping(const PageMapping &) = delete;
+    PageMapping &operator=(const PageMapping &) = delete;
+
+    PageMapping(PageMapping &&other) noexcept
+        : m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0)},
+          m_mode{other.m_mode}
+    {
+    }
+
+    PageMapping &operator=(PageMapping &&other) noexcept
+    {
+        if (this != &other)
+        {
+            _unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_mode = other.m_mode;
+        }
+        return *this;
+    }
+
+    ~PageMapping() noexcept
+    {
+        _unmap();
+    }
+
+    /// @brief Maps at least `bytes` zeroed bytes, rounded up to whole pages of
+    /// the mode used (2 MiB for either huge page mode).
+    static auto map(sz_t bytes, PageConfig config = {}) -> std::expected<PageMapping, FileError>
+    {
+        PageMapping mapping;
+        void *p = MAP_FAILED;
+        sz_t size = 0;
+        PageMode mode = config.pages;
+        if (mode == PageMode::HUGETLB)
+        {
+            size = _round_up(bytes, HUGE_PAGE_SIZE);
+            p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT), -1, 0);
+            if (p == MAP_FAILED) // no pool configured, or it ran dry
+                mode = PageMode::TRANSPARENT_HUGE;
+        }
+        if (p == MAP_FAILED)
+        {
+            size = _round_up(bytes, mode == PageMode::DEFAULT ? _base_page_size() : HUGE_PAGE_SIZE);
+            p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED)
+                return std::unexpected(FileError::MMAP_FAIL);
+            // Advice only: THP may be disabled, which is not an error
+            if (mode == PageMode::TRANSPARENT_HUGE)
+                ::madvise(p, size, MADV_HUGEPAGE);
+        }
+        mapping.m_data = static_cast<std::byte *>(p);
+        mapping.m_size = size;
+        mapping.m_mode = mode;
+
+        // After the advice, so THP can fault in whole huge pages
+        if (config.prefault)
+        {
+            volatile std::byte *touch = mapping.m_data;
+            for (sz_t off = 0; off < size; off += _base_page_size())
+                touch[off] = std::byte{0};
+        }
+        return mapping;
+    }
+
+    [[nodiscard]] std::byte *data() const noexcept
+    {
+        return m_data;
+    }
+
+    [[nodiscard]] sz_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] PageMode mode() const noexcept
+    {
+        return m_mode;
+    }
+
+  private:
+    std::byte *m_data{nullptr};
+    sz_t m_size{0};
+    PageMode m_mode{PageMode::DEFAULT};
+
+    static sz_t _base_page_size() noexcept
+    {
+        static const auto page = static_cast<sz_t>(::sysconf(_SC_PAGESIZE));
+        return page;
+    }
+
+    static constexpr sz_t _round_up(sz_t bytes, sz_t page) noexcept
+    {
+        return bytes == 0 ? page : (bytes + page - 1) / page * page;
+    }
+
+    void _unmap() noexcept
+    {
+        if (m_data)
+            ::munmap(m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+};
+
+} // End namespace fiah
@@ -0,0 +1,244 @@
+#pragma once
+
+// C++ Includes
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+// FastInAHurry Includes
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Open-addressing hash map from an unsigned integer id to a small value.
+///
+/// Linear probing over a power-of-two slot array with Fibonacci hashing, kept
+/// at most half full. Erase uses backward-shift deletion instead of tombstones,
+/// so probe lengths do not creep up under insert/erase churn (e.g. cancel-heavy
+/// order flow) and lookups stay O(1) without periodic rehashing.
+///
+/// @tparam Key Unsigned integral id. The all-ones value is reserved as the
+/// empty-slot marker: it must never be inserted, and find() and erase()
+/// always report it absent.
+/// @tparam Value Trivially copyable payload (an index, a pointer, a price...).
+template <std::unsigned_integral Key, class Value>
+    requires std::is_trivially_copyable_v<Value>
+class FlatIdMap
+{
+  public:
+    static constexpr Key EMPTY_KEY{std::numeric_limits<Key>::max()};
+    static constexpr sz_t MIN_CAPACITY{16};
+
+    struct Slot
+    {
+        Key key{EMPTY_KEY};
+        Value value{};
+    };
+
+    FlatIdMap() noexcept = default;
+
+    explicit FlatIdMap(sz_t expected_size)
+    {
+        reserve(expected_size);
+    }
+
+    /// @brief Grows the table so that `n` entries fit without rehashing.
+    void reserve(sz_t n)
+    {
+        const sz_t wanted = std::bit_ceil(std::max(n * 2, MIN_CAPACITY));
+        if (wanted > m_slots.size())
+            _rehash(wanted);
+    }
+
+    /// @return Pointer to the mapped value, or nullptr if `key` is absent.
+    [[nodiscard, gnu::always_inline]]
+    Value *find(Key key) noexcept
+    {
+        // EMPTY_KEY would "match" the first free slot it probes
+        if (m_slots.empty() || key == EMPTY_KEY) [[unlikely]]
+            return nullptr;
+        for (sz_t i = _home(key);; i = (i + 1) & m_mask)
+        {
+            Slot &slot = m_slots[i];
+            if (slot.key == key)
+                return &slot.value;
+            if (slot.key == EMPTY_KEY)
+                return nullptr;
+        }
+    }
+
+    [[nodiscard, gnu::always_inline]]
+    const Value *find(Key key) const noexcept
+    {
+        return const_cast<FlatIdMap *>(this)->find(key);
+    }
+
+    [[nodiscard, gnu::always_inline]]
+    bool contains(Key key) const noexcept
+    {
+        return find(key) != nullptr;
+    }
+
+    /// @brief Pulls the home slot of `key` into cache ahead of a lookup.
+    [[gnu::always_inline]]
+    void prefetch(Key key) const noexcept
+    {
+        if (!m_slots.empty()) [[likely]]
+            __builtin_prefetch(&m_slots[_home(key)]);
+    }
+
+    /// @return False (and leaves the map untouched) if `key` is already present.
+    bool insert(Key key, Value value)
+    {
+        assert(key != EMPTY_KEY);
+        if ((m_size + 1) * 2 > m_slots.size()) [[unlikely]]
+            _rehash(std::max(m_slots.size() * 2, MIN_CAPACITY));
+
+        for (sz_t i = _home(key);; i = (i + 1) & m_mask)
+        {
+            Slot &slot = m_slots[i];
+            if (slot.key == key)
+                return false;
+            if (slot.key == EMPTY_KEY)
+            {
+                slot = Slot{key, value};
+                ++m_size;
+                return true;
+            }
+        }
+    }
+
+    /// @return False if `key` was not present.
+    bool erase(Key key) noexcept
+    {
+        if (m_slots.empty() || key == EMPTY_KEY) [[unlikely]]
+            return false;
+
+        sz_t hole = _home(key);
+        for (;; hole = (hole + 1) & m_mask)
+        {
+            if (m_slots[hole].key == key)
+                break;
+            if (m_slots[hole].key == EMPTY_KEY)
+                return false;
+        }
+
+        // Backward shift: pull later members of the probe run into the hole
+        // whenever the hole lies between their home slot and where they sit.
+        for (sz_t next = (hole + 1) & m_mask;; next = (next + 1) & m_mask)
+        {
+            Slot &candidate = m_slots[next];
+            if (candidate.key == EMPTY_KEY)
+                break;
+            const sz_t home = _home(candidate.key);
+            if (((next - home) & m_mask) >= ((next - hole) & m_mask))
+            {
+                m_slots[hole] = candidate;
+                hole = next;
+            }
+        }
+        m_slots[hole].key = EMPTY_KEY;
+        --m_size;
+        return true;
+    }
+
+    void clear() noexcept
+    {
+        for (Slot &slot : m_slots)
+            slot.key = EMPTY_KEY;
+        m_size = 0;
+    }
+
+    [[nodiscard]] sz_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] sz_t capacity() const noexcept
+    {
+        return m_slots.size() / 2;
+    }
+
+    /// @brief Raw slot array, empty slots included. Slot positions depend
+    /// only on the keys and the array size, so a copy of it (with values
+    /// translated) is a valid table for any map of the same Key type.
+    [[nodiscard]] std::span<const Slot> slots() const noexcept
+    {
+        return m_slots;
+    }
+
+    /// @brief Adopts a slot array produced by slots(), possibly from a map
+    /// with a different value type, without rehashing a single key.
+    /// @param map_value Translates each occupied slot's value.
+    /// @return False if `src` is not a valid table size.
+    template <class SrcSlot, class MapValue>
+    bool assign_slots(std::span<const SrcSlot> src, MapValue &&map_value)
+    {
+        if (src.size() < MIN_CAPACITY || !std::has_single_bit(src.size()))
+            return false;
+        m_slots.assign(src.size(), Slot{});
+        m_mask = src.size() - 1;
+        m_shift = static_cast<u32_t>(64 - std::countr_zero(src.size()));
+        m_size = 0;
+        Slot *dst = m_slots.data();
+        for (sz_t i = 0; i < src.size(); ++i)
+        {
+            if (src[i].key == EMPTY_KEY)
+                continue;
+            dst[i] = Slot{src[i].key, map_value(src[i].value)};
+            ++m_size;
+        }
+        return m_size * 2 <= m_slots.size();
+    }
+
+  private:
+    static constexpr u64_t FIBONACCI_MULTIPLIER{0x9E3779B97F4A7C15ULL};
+
+    std::vector<Slot> m_slots{};
+    sz_t m_mask{};
+    sz_t m_size{};
+    u32_t m_shift{64};
+
+    [[gnu::always_inline]]
+    sz_t _home(Key key) const noexcept
+    {
+        return static_cast<sz_t>((static_cast<u64_t>(key) * FIBONACCI_MULTIPLIER) >> m_shift);
+    }
+
+    [[gnu::cold, gnu::noinline]]
+    void _rehash(sz_t new_capacity)
+    {
+        std::vector<Slot> old = std::exchange(m_slots, std::vector<Slot>(new_capacity));
+        m_mask = new_capacity - 1;
+        m_shift = static_cast<u32_t>(64 - std::countr_zero(new_capacity));
+        m_size = 0;
+        for (const Slot &slot : old)
+        {
+            if (slot.key == EMPTY_KEY)
+                continue;
+            for (sz_t i = _home(slot.key);; i = (i + 1) & m_mask)
+            {
+                if (m_slots[i].key == EMPTY_KEY)
+                {
+                    m_slots[i] = slot;
+                    ++m_size;
+                    break;
+                }
+            }
+        }
+    }
+};
+
+} // End namespace fiah
@@ -0,0 +1,185 @@
+#pragma once
+
+// C++ Includes
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// FastInAHurry Includes
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Fixed-capacity contiguous sequence stored inline, for trivially
+/// copyable elements. The subset of the std::vector interface the books use,
+/// with the capacity a compile-time constant: it never allocates, and every
+/// bound the compiler sees is `N`.
+///
+/// @attention Inserting into a full vector is a precondition violation, not
+/// an error; check full() first.
+template <class T, sz_t N>
+    requires std::is_trivially_copyable_v<T> && (N > 0)
+class InplaceVector
+{
+  public:
+    using value_type = T;
+    using size_type = sz_t;
+    using iterator = T *;
+    using const_iterator = const T *;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    constexpr InplaceVector() noexcept = default;
+
+    static constexpr sz_t capacity() noexcept
+    {
+        return N;
+    }
+
+    /// @brief No-op; the capacity is fixed. Lets generic code keep calling
+    /// reserve() on either container.
+    constexpr void reserve(sz_t) const noexcept
+    {
+    }
+
+    [[nodiscard]] sz_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] bool full() const noexcept
+    {
+        return m_size == N;
+    }
+
+    T *data() noexcept
+    {
+        return std::launder(reinterpret_cast<T *>(m_storage));
+    }
+
+    const T *data() const noexcept
+    {
+        return std::launder(reinterpret_cast<const T *>(m_storage));
+    }
+
+    iterator begin() noexcept
+    {
+        return data();
+    }
+
+    iterator end() noexcept
+    {
+        return data() + m_size;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return data();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return data() + m_size;
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator{end()};
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator{begin()};
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator{end()};
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator{begin()};
+    }
+
+    T &operator[](sz_t i) noexcept
+    {
+        return data()[i];
+    }
+
+    const T &operator[](sz_t i) const noexcept
+    {
+        return data()[i];
+    }
+
+    T &back() noexcept
+    {
+        return data()[m_size - 1];
+    }
+
+    const T &back() const noexcept
+    {
+        return data()[m_size - 1];
+    }
+
+    /// @pre !full()
+    void push_back(const T &value) noexcept
+    {
+        assert(!full());
+        std::construct_at(data() + m_size++, value);
+    }
+
+    void pop_back() noexcept
+    {
+        --m_size;
+    }
+
+    /// @pre !full()
+    iterator insert(const_iterator pos, const T &value) noexcept
+    {
+        assert(!full());
+        T *at = data() + (pos - data());
+        std::memmove(static_cast<void *>(at + 1), at, static_cast<sz_t>(end() - at) * sizeof(T));
+        std::construct_at(at, value);
+        ++m_size;
+        return at;
+    }
+
+    iterator erase(const_iterator pos) noexcept
+    {
+        T *at = data() + (pos - data());
+        std::memmove(static_cast<void *>(at), at + 1, static_cast<sz_t>(end() - at - 1) * sizeof(T));
+        --m_size;
+        return at;
+    }
+
+    /// @pre last - first <= N
+    template <class It> void assign(It first, It last) noexcept
+    {
+        assert(static_cast<sz_t>(std::distance(first, last)) <= N);
+        m_size = 0;
+        for (; first != last; ++first)
+            std::construct_at(data() + m_size++, *first);
+    }
+
+    void clear() noexcept
+    {
+        m_size = 0;
+    }
+
+  private:
+    alignas(T) std::byte m_storage[N * sizeof(T)];
+    sz_t m_size{0};
+};
+
+} // End namespace fiah
@@ -0,0 +1,742 @@
+#pragma once
+
+// C++ Includes
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// FastInAHurry Includes
+#include "fiah/error/Error.hh"
+#include "fiah/io/BinaryImage.hh"
+#include "fiah/memory/ObjectPool.hh"
+#include "fiah/structs/FlatIdMap.hh"
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Price-ladder limit order book with O(1) access to any price level.
+///
+/// Levels live in a power-of-two ring indexed by tick (`price & mask`), covering
+/// a window of `num_levels` consecutive prices. The window slides toward
+/// incoming prices for as long as every resting order still fits in it; an
+/// order whose remainder cannot be placed on the ladder is dropped after
+/// matching, the same way a dupe is.
+///
+/// Best bid/ask are kept as cursors into the ladder. They only walk when the
+/// best level empties, and then only across the gap to the next live level,
+/// skipping 64 empty ticks at a time through an occupancy bitmap.
+/// Each level is an intrusive doubly-linked FIFO of order nodes drawn from a
+/// fixed-capacity ObjectPool, and an id index maps every resting order to its
+/// node. Dupe checks are a single probe, cancels unlink in O(1), fills pop the
+/// head, and nothing touches the heap once the pool is warm. Every level also
+/// keeps its aggregate quantity and order count, so depth snapshots never
+/// look at individual orders.
+///
+/// Matching semantics (price-time priority, trade price and trade layout) are
+/// identical to `Orderbook`, so the two can be swapped behind `OrderbookLike`.
+class LadderOrderbook
+{
+  public:
+    static constexpr sz_t DEFAULT_NUM_LEVELS{1 << 12};
+    static constexpr sz_t DEFAULT_MAX_ORDERS{1 << 16};
+    static constexpr sz_t PREFETCH_DISTANCE{4};
+    /// Largest window and order pool restore_snapshot() will allocate; an
+    /// image asking for more is treated as corrupt.
+    static constexpr sz_t MAX_RESTORE_LEVELS{sz_t{1} << 24};
+    static constexpr sz_t MAX_RESTORE_ORDERS{sz_t{1} << 26};
+    /// The one id the index cannot hold; AddOrder() drops orders carrying it.
+    static constexpr Id RESERVED_ID{std::numeric_limits<Id>::max()}; // FlatIdMap::EMPTY_KEY
+
+    /// @param num_levels Width of the price window in ticks, rounded up to a
+    /// power of two (at least 64).
+    /// @param max_orders Resting order capacity. Remainders that would exceed
+    /// it are dropped like out-of-window ones.
+    explicit LadderOrderbook(sz_t num_levels = DEFAULT_NUM_LEVELS, sz_t max_orders = DEFAULT_MAX_ORDERS)
+        : LadderOrderbook(num_levels, max_orders, NoIndexReserve{})
+    {
+        m_index.reserve(max_orders);
+    }
+
+    [[nodiscard]]
+    Trades AddOrder(const Order &incoming)
+    {
+        Trades trades;
+        AddOrder(incoming, [&trades](const Trade &trade) { trades.push_back(trade); });
+        return trades;
+    }
+
+    /// @brief Allocation-free matching: every trade goes straight to `sink`.
+    template <TradeSink Sink> void AddOrder(const Order &incoming, Sink &&sink)
+    {
+        if (incoming.get_id() == RESERVED_ID || is_dupe(incoming))
+            return;
+        if (incoming.get_type() == Order::Type::FOK && !can_fill(incoming))
+            return;
+
+        Quantity remaining = incoming.is_buy() ? _match<true>(incoming, sink) : _match<false>(incoming, sink);
+
+        if (remaining > 0 && incoming.rests())
+        {
+            Order corrected_incoming = incoming;
+            corrected_incoming.set_qty(remaining);
+            (void)_rest(corrected_incoming);
+        }
+    }
+
+    /// @return True if the opposite side holds enough crossing quantity to
+    /// fill `order` completely. Reads level aggregates only, one level at a
+    /// time from the touch, and stops as soon as it has seen enough. Counts
+    /// down what is still needed, so it cannot overflow Quantity.
+    bool can_fill(const Order &order) const noexcept
+    {
+        const bool is_buy = order.is_buy();
+        sz_t levels = is_buy ? m_num_ask_levels : m_num_bid_levels;
+        Price price = is_buy ? m_best_ask : m_best_bid;
+        Quantity needed = order.get_qty();
+        while (levels-- > 0 && order.crosses(price))
+        {
+            const Quantity here = _level_at(price).total_qty;
+            if (here >= needed)
+                return true;
+            needed -= here;
+            if (levels > 0)
+                price = is_buy ? _next_live_up(price + 1) : _next_live_down(price - 1);
+        }
+        return false;
+    }
+
+    /// @brief Matches a batch in order, with the same results as calling
+    /// AddOrder on each element. While one order is matched, the id-index slot
+    /// and price level of an order PREFETCH_DISTANCE places ahead are already
+    /// being pulled into cache.
+    template <TradeSink Sink> void AddOrders(std::span<const Order> orders, Sink &&sink)
+    {
+        const sz_t n = orders.size();
+        for (sz_t i = 0; i < std::min(n, PREFETCH_DISTANCE); ++i)
+            _prefetch(orders[i]);
+        for (sz_t i = 0; i < n; ++i)
+        {
+            if (i + PREFETCH_DISTANCE < n)
+                _prefetch(orders[i + PREFETCH_DISTANCE]);
+            AddOrder(orders[i], sink);
+        }
+    }
+
+    void CancelOrder(Id order_id)
+    {
+        OrderNode **slot = m_index.find(order_id);
+        if (!slot)
+            return;
+
+        OrderNode *node = *slot;
+        m_index.erase(order_id);
+        _unlink(node);
+        m_pool.destroy(node);
+    }
+
+    [[nodiscard]]
+    Trades ModifyOrder(Id order_id, Quantity new_qty, Price new_price)
+    {
+        Trades trades;
+        ModifyOrder(order_id, new_qty, new_price, [&trades](const Trade &trade) { trades.push_back(trade); });
+        return trades;
+    }
+
+    /// @brief Amends a resting order in one pass. Shrinking at the same price
+    /// is done in place and keeps queue priority. A price change or size
+    /// increase re-queues the order as an aggressor, reusing its node, so it
+    /// may trade; a non-positive quantity cancels. Unknown ids are ignored.
+    template <TradeSink Sink> void ModifyOrder(Id order_id, Quantity new_qty, Price new_price, Sink &&sink)
+    {
+        OrderNode **slot = m_index.find(order_id);
+        if (!slot)
+            return;
+
+        OrderNode *node = *slot;
+        if (new_qty <= 0)
+            return CancelOrder(order_id);
+
+        if (new_price == node->price && new_qty <= node->qty)
+        {
+            _level_at(node->price).total_qty -= node->qty - new_qty;
+            node->qty = new_qty;
+            return;
+        }
+
+        _unlink(node);
+        const Order amended{order_id, new_price, node->is_buy, new_qty};
+        Quantity remaining = node->is_buy ? _match<true>(amended, sink) : _match<false>(amended, sink);
+
+        node->price = new_price;
+        node->qty = remaining;
+        if (remaining > 0 && _place(node))
+            return;
+
+        m_index.erase(order_id);
+        m_pool.destroy(node);
+    }
+
+    bool is_dupe(const Order &order)
+    {
+        return m_index.contains(order.get_id());
+    }
+
+    /// @return Number of resting orders across both sides.
+    sz_t size() const noexcept
+    {
+        return m_index.size();
+    }
+
+    bool has_bids() const noexcept
+    {
+        return m_num_bids > 0;
+    }
+
+    bool has_asks() const noexcept
+    {
+        return m_num_asks > 0;
+    }
+
+    /// @pre has_bids()
+    Price best_bid() const noexcept
+    {
+        return m_best_bid;
+    }
+
+    /// @pre has_asks()
+    Price best_ask() const noexcept
+    {
+        return m_best_ask;
+    }
+
+    sz_t num_levels() const noexcept
+    {
+        return m_levels.size();
+    }
+
+    /// @brief Copies up to `out.size()` best levels of one side, best first.
+    /// Costs O(levels copied) plus one bitmap word per 64 empty ticks crossed.
+    /// @return Number of levels written.
+    sz_t top_levels(Order::Side side, std::span<DepthLevel> out) const noexcept
+    {
+        const bool is_buy = side == Order::Side::BUY;
+        const sz_t n = std::min(out.size(), is_buy ? m_num_bid_levels : m_num_ask_levels);
+        Price price = is_buy ? m_best_bid : m_best_ask;
+        for (sz_t i = 0; i < n; ++i)
+        {
+            if (i > 0)
+                price = is_buy ? _next_live_down(price - 1) : _next_live_up(price + 1);
+            const Level &level = _level_at(price);
+            out[i] = DepthLevel{price, level.total_qty, level.count};
+        }
+        return n;
+    }
+
+    /// @brief Writes the whole book (window, levels, every order in queue
+    /// order and the id index) to `path` as a position-independent image:
+    /// node links are indices, never pointers.
+    /// @param journal_seq Last journal sequence number reflected in the book,
+    /// so recovery knows where to resume replay (see Journal.hh).
+    auto save_snapshot(const std::string &path, u64_t journal_seq = 0) const -> std::expected<void, FileError>
+    {
+        std::vector<NodeImage> nodes;
+        nodes.reserve(size());
+        std::vector<LevelImage> levels(m_levels.size(), LevelImage{NIL, NIL, 0, 0});
+        IndexImage index(size());
+
+        for (sz_t cell = 0; cell < m_levels.size(); ++cell)
+        {
+            const Level &level = m_levels[cell];
+            if (level.empty())
+                continue;
+            const auto first = static_cast<u32_t>(nodes.size());
+            for (const OrderNode *node = level.head; node; node = node->next)
+            {
+                const auto idx = static_cast<u32_t>(nodes.size());
+                nodes.push_back(NodeImage{node->id, node->price, node->qty, idx == first ? NIL : idx - 1,
+                                          node->next ? idx + 1 : NIL, node->is_buy});
+                index.insert(node->id, idx);
+            }
+            levels[cell] = LevelImage{first, static_cast<u32_t>(nodes.size() - 1), level.total_qty, level.count};
+        }
+
+        auto writer = ImageWriter::create(path, sizeof(ImageHeader));
+        if (!writer)
+            return std::unexpected(writer.error());
+        auto node_section = writer->append(std::span<const NodeImage>{nodes});
+        auto level_section = writer->append(std::span<const LevelImage>{levels});
+        auto occupied_section = writer->append(std::span<const u64_t>{m_occupied});
+        auto index_section = writer->append(index.slots());
+        if (!node_section || !level_section || !occupied_section || !index_section)
+            return std::unexpected(FileError::WRITE_FAIL);
+
+        return writer->commit(ImageHeader{.journal_seq = journal_seq,
+                                          .num_levels = m_levels.size(),
+                                          .max_orders = m_pool.capacity(),
+                                          .low = m_low,
+                                          .best_bid = m_best_bid,
+                                          .best_ask = m_best_ask,
+                                          .num_bids = m_num_bids,
+                                          .num_asks = m_num_asks,
+                                          .num_bid_levels = m_num_bid_levels,
+                                          .num_ask_levels = m_num_ask_levels,
+                                          .nodes = *node_section,
+                                          .levels = *level_section,
+                                          .occupied = *occupied_section,
+                                          .index = *index_section});
+    }
+
+    /// @brief Rebuilds a book from save_snapshot() output. Nodes are copied
+    /// into the pool and each level's queue is relinked by walking its list
+    /// from the head, so level aggregates, the occupancy bitmap, the side
+    /// counts and the best prices are all recomputed from the orders and then
+    /// checked against what the image recorded. The id index is adopted slot
+    /// for slot without rehashing, then every node is looked up through it.
+    /// @return BAD_HEADER for a header out of bounds, BAD_RECORD for an order
+    /// outside the window or with a non-positive qty, a list that is broken or
+    /// mixes prices or sides, a crossed book, an index that does not map each
+    /// id to its own node, or recorded aggregates that disagree with the orders.
+    /// @param journal_seq If set, receives the sequence number passed to
+    /// save_snapshot().
+    static auto restore_snapshot(const std::string &path, u64_t *journal_seq = nullptr)
+        -> std::expected<LadderOrderbook, FileError>
+    {
+        auto reader = ImageReader::open(path);
+        if (!reader)
+            return std::unexpected(reader.error());
+        auto header = reader->header<ImageHeader>();
+        if (!header)
+            return std::unexpected(header.error());
+        const ImageHeader &h = *header;
+        // Bounds first: a corrupt header must not size the allocations below
+        if (h.magic != ImageHeader::MAGIC || h.version != ImageHeader::VERSION || h.num_levels < BITS_PER_WORD ||
+            h.num_levels > MAX_RESTORE_LEVELS || !std::has_single_bit(h.num_levels) ||
+            h.max_orders > MAX_RESTORE_ORDERS || h.nodes.count > h.max_orders || h.nodes.count >= NIL ||
+            h.levels.count != h.num_levels || h.occupied.count != h.num_levels / BITS_PER_WORD ||
+            h.low > std::numeric_limits<Price>::max() - static_cast<Price>(h.num_levels))
+            return std::unexpected(FileError::BAD_HEADER);
+
+        auto nodes = reader->section<NodeImage>(h.nodes);
+        auto levels = reader->section<LevelImage>(h.levels);
+        auto occupied = reader->section<u64_t>(h.occupied);
+        auto index = reader->section<IndexImage::Slot>(h.index);
+        if (!nodes || !levels || !occupied || !index)
+            return std::unexpected(FileError::TRUNCATED);
+
+        // The index is adopted from the image below; sizing it here would only
+        // allocate and zero a table that is thrown away
+        LadderOrderbook book{h.num_levels, h.max_orders, NoIndexReserve{}};
+        book.m_low = h.low;
+        const sz_t n = nodes->size();
+        std::vector<OrderNode *> ptrs(n);
+        for (sz_t i = 0; i < n; ++i)
+        {
+            const NodeImage &img = (*nodes)[i];
+            if (img.qty <= 0 || !book._in_window(img.price))
+                return std::unexpected(FileError::BAD_RECORD);
+            ptrs[i] = book.m_pool.create(OrderNode{nullptr, nullptr, img.id, img.price, img.qty, img.is_buy});
+        }
+
+        // Each price's queue is exactly one list, held in that price's cell;
+        // _place() then rebuilds links, aggregates and cursors in queue order
+        std::vector<bool> seen(n);
+        for (sz_t cell = 0; cell < h.num_levels; ++cell)
+        {
+            const LevelImage &img = (*levels)[cell];
+            if (img.head == NIL)
+            {
+                if (img.tail != NIL)
+                    return std::unexpected(FileError::BAD_RECORD);
+                continue;
+            }
+            if (img.head >= n || book._cell(ptrs[img.head]->price) != cell)
+                return std::unexpected(FileError::BAD_RECORD);
+            const OrderNode &first = *ptrs[img.head];
+            u32_t last = NIL;
+            for (u32_t i = img.head; i != NIL; last = i, i = (*nodes)[i].next)
+            {
+                if (i >= n || seen[i] || (*nodes)[i].prev != last || ptrs[i]->price != first.price ||
+                    ptrs[i]->is_buy != first.is_buy ||
+                    ptrs[i]->qty > std::numeric_limits<Quantity>::max() - book.m_levels[cell].total_qty)
+                    return std::unexpected(FileError::BAD_RECORD);
+                seen[i] = true;
+                (void)book._place(ptrs[i]);
+            }
+            const Level &level = book.m_levels[cell];
+            if (last != img.tail || level.total_qty != img.total_qty || level.count != img.count)
+                return std::unexpected(FileError::BAD_RECORD);
+        }
+        if (book.m_num_bids + book.m_num_asks != n ||
+            (book.has_bids() && book.has_asks() && book.m_best_bid >= book.m_best_ask) ||
+            book.m_num_bids != h.num_bids || book.m_num_asks != h.num_asks ||
+            book.m_num_bid_levels != h.num_bid_levels || book.m_num_ask_levels != h.num_ask_levels ||
+            (book.has_bids() && book.m_best_bid != h.best_bid) ||
+            (book.has_asks() && book.m_best_ask != h.best_ask) || !std::ranges::equal(*occupied, book.m_occupied))
+            return std::unexpected(FileError::BAD_RECORD);
+
+        bool links_ok = true;
+        auto link = [&](u64_t idx) -> OrderNode * {
+            if (idx >= n) [[unlikely]]
+            {
+                links_ok = false;
+                return nullptr;
+            }
+            return ptrs[idx];
+        };
+        if (!book.m_index.assign_slots(*index, link) || !links_ok || book.m_index.size() != n)
+            return std::unexpected(FileError::BAD_RECORD);
+        for (OrderNode *node : ptrs)
+            if (OrderNode *const *slot = book.m_index.find(node->id); !slot || *slot != node)
+                return std::unexpected(FileError::BAD_RECORD);
+
+        if (journal_seq)
+            *journal_seq = h.journal_seq;
+        return book;
+    }
+
+  private:
+    struct NoIndexReserve
+    {
+    };
+
+    LadderOrderbook(sz_t num_levels, sz_t max_orders, NoIndexReserve)
+        : m_levels(std::bit_ceil(std::max(num_levels, BITS_PER_WORD))), m_occupied(m_levels.size() / BITS_PER_WORD),
+          m_mask{m_levels.size() - 1}, m_pool(max_orders)
+    {
+    }
+
+    struct OrderNode
+    {
+        OrderNode *prev;
+        OrderNode *next;
+        Id id;
+        Price price;
+        Quantity qty;
+        bool is_buy;
+    };
+
+    /// Intrusive FIFO of resting orders at one price: append at the tail, fill
+    /// from the head, unlink from anywhere. Aggregates track the list.
+    struct Level
+    {
+        OrderNode *head{nullptr};
+        OrderNode *tail{nullptr};
+        Quantity total_qty{};
+        u32_t count{};
+
+        bool empty() const noexcept
+        {
+            return head == nullptr;
+        }
+
+        void push_back(OrderNode *node) noexcept
+        {
+            node->prev = tail;
+            node->next = nullptr;
+            (tail ? tail->next : head) = node;
+            tail = node;
+            total_qty += node->qty;
+            ++count;
+        }
+
+        void unlink(OrderNode *node) noexcept
+        {
+            (node->prev ? node->prev->next : head) = node->next;
+            (node->next ? node->next->prev : tail) = node->prev;
+            total_qty -= node->qty;
+            --count;
+        }
+    };
+
+    static constexpr sz_t BITS_PER_WORD{64};
+
+    // Snapshot image records. Links are node indices (NIL for none), so the
+    // image means the same thing wherever it is mapped.
+    static constexpr u32_t NIL{~u32_t{0}};
+
+    struct NodeImage
+    {
+        Id id;
+        Price price;
+        Quantity qty;
+        u32_t prev;
+        u32_t next;
+        bool is_buy;
+        u8_t pad[3]{};
+    };
+
+    struct LevelImage
+    {
+        u32_t head;
+        u32_t tail;
+        Quantity total_qty;
+        u32_t count;
+    };
+
+    // Node indices are stored widened so the slots have no padding either
+    using IndexImage = FlatIdMap<Id, u64_t>;
+
+    // Every byte of the image is a field, so saving the same book twice
+    // writes the same file and never leaks uninitialised memory
+    static_assert(std::has_unique_object_representations_v<NodeImage> &&
+                  std::has_unique_object_representations_v<LevelImage> &&
+                  std::has_unique_object_representations_v<IndexImage::Slot>);
+
+    struct ImageHeader
+    {
+        static constexpr u64_t MAGIC{0x5244'414C'4841'4946ULL}; // "FIAHLADR"
+        static constexpr u32_t VERSION{3}; // 2: carries journal_seq, 3: 64-bit index values
+
+        u64_t magic{MAGIC};
+        u32_t version{VERSION};
+        u32_t reserved{0};
+        u64_t journal_seq{0};
+        u64_t num_levels;
+        u64_t max_orders;
+        Price low;
+        Price best_bid;
+        Price best_ask;
+        u64_t num_bids;
+        u64_t num_asks;
+        u64_t num_bid_levels;
+        u64_t num_ask_levels;
+        ImageSection nodes;
+        ImageSection levels;
+        ImageSection occupied;
+        ImageSection index;
+    };
+
+    std::vector<Level> m_levels;
+    std::vector<u64_t> m_occupied; // one bit per ring cell, set while the level is live
+    sz_t m_mask;
+    ObjectPool<OrderNode> m_pool;
+    FlatIdMap<Id, OrderNode *> m_index;
+    Price m_low{}; // lowest price covered by the window
+    Price m_best_bid{};
+    Price m_best_ask{};
+    sz_t m_num_bids{};
+    sz_t m_num_asks{};
+    sz_t m_num_bid_levels{};
+    sz_t m_num_ask_levels{};
+
+    sz_t _cell(Price price) const noexcept
+    {
+        return static_cast<sz_t>(price) & m_mask;
+    }
+
+    Level &_level_at(Price price) noexcept
+    {
+        return m_levels[_cell(price)];
+    }
+
+    const Level &_level_at(Price price) const noexcept
+    {
+        return m_levels[_cell(price)];
+    }
+
+    [[gnu::always_inline]]
+    void _prefetch(const Order &order) const noexcept
+    {
+        m_index.prefetch(order.get_id());
+        if (_in_window(order.get_level()))
+            __builtin_prefetch(&_level_at(order.get_level()), 1);
+    }
+
+    void _mark(Price price, bool live) noexcept
+    {
+        const sz_t cell = _cell(price);
+        const u64_t bit = u64_t{1} << (cell % BITS_PER_WORD);
+        if (live)
+            m_occupied[cell / BITS_PER_WORD] |= bit;
+        else
+            m_occupied[cell / BITS_PER_WORD] &= ~bit;
+    }
+
+    /// @pre A live level exists at or above `price` within the window.
+    Price _next_live_up(Price price) const noexcept
+    {
+        for (;;)
+        {
+            const sz_t cell = _cell(price);
+            const sz_t offset = cell % BITS_PER_WORD;
+            if (const u64_t bits = m_occupied[cell / BITS_PER_WORD] >> offset)
+                return price + std::countr_zero(bits);
+            price += static_cast<Price>(BITS_PER_WORD - offset);
+        }
+    }
+
+    /// @pre A live level exists at or below `price` within the window.
+    Price _next_live_down(Price price) const noexcept
+    {
+        for (;;)
+        {
+            const sz_t cell = _cell(price);
+            const sz_t offset = cell % BITS_PER_WORD;
+            if (const u64_t bits = m_occupied[cell / BITS_PER_WORD] << (BITS_PER_WORD - 1 - offset))
+                return price - std::countl_zero(bits);
+            price -= static_cast<Price>(offset + 1);
+        }
+    }
+
+    bool _in_window(Price price) const noexcept
+    {
+        return price >= m_low && static_cast<sz_t>(price - m_low) < m_levels.size();
+    }
+
+    bool _empty() const noexcept
+    {
+        return (m_num_bids | m_num_asks) == 0;
+    }
+
+    template <bool IsBuy, class Sink> Quantity _match(const Order &incoming, Sink &sink)
+    {
+        Quantity remaining = incoming.get_qty();
+        const sz_t &num_opposite = IsBuy ? m_num_asks : m_num_bids;
+        Price &best = IsBuy ? m_best_ask : m_best_bid;
+
+        while (num_opposite > 0 && remaining > 0)
+        {
+            if (!incoming.crosses(best))
+                break;
+
+            OrderNode *resting = _level_at(best).head;
+            Quantity trade_size = std::min(resting->qty, remaining);
+
+            // Same conventions as Orderbook: price comes from the ask side
+            // (the bid's for a market sell), bid order id first, incoming
+            // order is always the aggressor.
+            Price trade_price = IsBuy || incoming.is_market() ? best : incoming.get_level();
+            Id bid_order_id = IsBuy ? incoming.get_id() : resting->id;
+            Id ask_order_id = IsBuy ? resting->id : incoming.get_id();
+            sink(Trade{bid_order_id, ask_order_id, incoming.get_id(), IsBuy, trade_price, trade_size});
+
+            resting->qty -= trade_size;
+            _level_at(best).total_qty -= trade_size;
+            remaining -= trade_size;
+
+            // Unlinking the last order of the level moves `best` on
+            if (resting->qty == 0)
+            {
+                m_index.erase(resting->id);
+                _unlink(resting);
+                m_pool.destroy(resting);
+            }
+        }
+        return remaining;
+    }
+
+    bool _rest(const Order &order)
+    {
+        OrderNode *node = m_pool.create(
+            OrderNode{nullptr, nullptr, order.get_id(), order.get_level(), order.get_qty(), order.is_buy()});
+        if (!node) [[unlikely]]
+            return false;
+
+        if (!_place(node)) [[unlikely]]
+        {
+            m_pool.destroy(node);
+            return false;
+        }
+        m_index.insert(order.get_id(), node);
+        return true;
+    }
+
+    /// @brief Appends a detached node to the tail of its price level.
+    bool _place(OrderNode *node)
+    {
+        const Price price = node->price;
+        if (!_in_window(price) && !_slide_window(price)) [[unlikely]]
+            return false;
+
+        Level &level = _level_at(price);
+        if (level.empty())
+        {
+            _mark(price, true);
+            ++(node->is_buy ? m_num_bid_levels : m_num_ask_levels);
+        }
+        level.push_back(node);
+
+        if (node->is_buy)
+        {
+            if (m_num_bids++ == 0 || price > m_best_bid)
+                m_best_bid = price;
+        }
+        else
+        {
+            if (m_num_asks++ == 0 || price < m_best_ask)
+                m_best_ask = price;
+        }
+        return true;
+    }
+
+    /// @brief Moves the window so that it covers `price` without evicting any
+    /// resting order. Cells that come into view are guaranteed empty: each one
+    /// last held a price that is now outside the window, hence not live.
+    [[gnu::cold, gnu::noinline]]
+    bool _slide_window(Price price)
+    {
+        const auto width = static_cast<Price>(m_levels.size());
+        if (_empty())
+        {
+            m_low = price - width / 2;
+            return true;
+        }
+
+        Price lo = price;
+        Price hi = price;
+        if (m_num_bids > 0)
+        {
+            lo = std::min(lo, _next_live_up(m_low));
+            hi = std::max(hi, m_best_bid);
+        }
+        if (m_num_asks > 0)
+        {
+            lo = std::min(lo, m_best_ask);
+            hi = std::max(hi, _next_live_down(m_low + width - 1));
+        }
+
+        const Price span = hi - lo + 1;
+        if (span > width)
+            return false;
+
+        m_low = lo - (width - span) / 2;
+        return true;
+    }
+
+    /// @brief Detaches a resting node from its level without releasing it.
+    /// If that empties the best level, the best cursor moves to the next live
+    /// level away from the spread.
+    void _unlink(OrderNode *node) noexcept
+    {
+        Level &level = _level_at(node->price);
+        level.unlink(node);
+        --(node->is_buy ? m_num_bids : m_num_asks);
+        if (!level.empty())
+            return;
+
+        _mark(node->price, false);
+        if (node->is_buy)
+        {
+            if (--m_num_bid_levels > 0 && node->price == m_best_bid)
+                m_best_bid = _next_live_down(m_best_bid - 1);
+        }
+        else
+        {
+            if (--m_num_ask_levels > 0 && node->price == m_best_ask)
+                m_best_ask = _next_live_up(m_best_ask + 1);
+        }
+    }
+};
+
+static_assert(OrderbookLike<LadderOrderbook>);
+
+} // End namespace fiah
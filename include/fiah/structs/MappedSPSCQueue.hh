@@ -0,0 +1,110 @@
+#pragma once
+
+// C++ Includes
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// FastInAHurry Includes
+#include "fiah/error/Error.hh"
+#include "fiah/memory/PageMapping.hh"
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+namespace detail
+{
+/// Ring storage in a PageMapping, capacity chosen at runtime.
+template <class T> class MappedRing
+{
+  public:
+    MappedRing(PageMapping mapping, u64_t capacity) noexcept
+        : m_mapping{std::move(mapping)}, m_capacity{capacity}, m_mask{capacity - 1}
+    {
+    }
+
+    u64_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    u64_t mask() const noexcept
+    {
+        return m_mask;
+    }
+
+    T *slot(u64_t idx) const noexcept
+    {
+        return std::launder(reinterpret_cast<T *>(m_mapping.data()) + (idx & m_mask));
+    }
+
+    const PageMapping &mapping() const noexcept
+    {
+        return m_mapping;
+    }
+
+  private:
+    PageMapping m_mapping;
+    u64_t m_capacity;
+    u64_t m_mask;
+};
+} // namespace detail
+
+/// @brief SPSCQueue with its capacity chosen at runtime and its ring in a
+/// PageMapping instead of inline: big rings neither blow the stack nor need a
+/// `new` of a multi-megabyte object, and by default they sit on transparent
+/// huge pages and are prefaulted, so the first lap after start-up takes no
+/// page faults and few TLB misses.
+///
+/// The protocol and interface are BasicSPSCQueue's, shared with SPSCQueue,
+/// minus array element types. The only cost of the runtime capacity is that
+/// the ring base and mask are loaded from a read-only line rather than folded
+/// into the code.
+///
+/// @attention One producer thread and one consumer thread.
+template <class T>
+    requires(!std::is_array_v<T>)
+class MappedSPSCQueue : public BasicSPSCQueue<T, detail::MappedRing<T>>
+{
+  public:
+    /// @param capacity Rounded up to a power of two.
+    /// @return MMAP_FAIL if the rounded capacity times sizeof(T) does not fit
+    /// in a mapping size.
+    static auto create(u64_t capacity, PageConfig config = {})
+        -> std::expected<std::unique_ptr<MappedSPSCQueue>, FileError>
+    {
+        constexpr u64_t MAX_CAPACITY{std::bit_floor(std::numeric_limits<sz_t>::max() / sizeof(T))};
+        if (capacity > MAX_CAPACITY)
+            return std::unexpected(FileError::MMAP_FAIL);
+        capacity = std::bit_ceil(std::max<u64_t>(capacity, 1));
+        auto mapping = PageMapping::map(capacity * sizeof(T), config);
+        if (!mapping)
+            return std::unexpected(mapping.error());
+        return std::unique_ptr<MappedSPSCQueue>{new MappedSPSCQueue{std::move(*mapping), capacity}};
+    }
+
+    /// @brief What the ring is actually mapped on, after any fallback.
+    PageMode page_mode() const noexcept
+    {
+        return this->ring().mapping().mode();
+    }
+
+  private:
+    MappedSPSCQueue(PageMapping mapping, u64_t capacity) noexcept
+        : BasicSPSCQueue<T, detail::MappedRing<T>>{detail::MappedRing<T>{std::move(mapping), capacity}}
+    {
+    }
+};
+
+} // End namespace fiah
@@ -2,41 +2,71 @@
 #include <algorithm>
 #include <cctype>
 #include <compare>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <expected>
 #include <iostream>
 #include <iterator>
 #include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "fiah/error/Error.hh"
+#include "fiah/io/BinaryImage.hh"
+#include "fiah/structs/FlatIdMap.hh"
+#include "fiah/structs/InplaceVector.hh"
+#include "fiah/utils/Probe.hh"
+
 using Id = size_t;
 using Price = long;
 using Quantity = int;
 
-class Order
+enum class OrderSide
+{
+    BUY,
+    SELL
+};
+
+/// How the order behaves once matching stops. Only LIMIT orders rest;
+/// the others drop whatever is left, so the book never inserts them.
+enum class OrderType : std::uint8_t
+{
+    LIMIT,
+    MARKET, ///< Trades at any price; `level` is ignored
+    IOC,    ///< Immediate-or-cancel: fill what crosses, drop the rest
+    FOK     ///< Fill-or-kill: fill completely right now or not at all
+};
+
+/// @brief An order over caller-chosen field types. `Order` below is the
+/// default 24-byte record; a book on 32-bit price/qty/id packs it into 16.
+template <std::integral P, std::integral Q, std::unsigned_integral I> class BasicOrder
 {
   public:
-    enum class Side
-    {
-        BUY,
-        SELL
-    };
+    using Side = OrderSide;
+    using Type = OrderType;
+    using price_type = P;
+    using quantity_type = Q;
+    using id_type = I;
 
   private:
-    Id id_;
-    Price level_;
+    I id_;
+    P level_;
     bool is_buy_;
-    Quantity qty_;
-    Side side_;
+    Type type_;
+    Q qty_;
 
   public:
-    Order(Id orderId, Price level, bool isBuy, Quantity quantity)
-        : id_{orderId}, level_{level}, is_buy_{isBuy}, qty_{quantity}, side_{isBuy ? Side::BUY : Side::SELL}
+    BasicOrder(I orderId, P level, bool isBuy, Q quantity, Type type = Type::LIMIT)
+        : id_{orderId}, level_{level}, is_buy_{isBuy}, type_{type}, qty_{quantity}
     {
     }
 
-    friend std::ostream &operator<<(std::ostream &os, const Order &o)
+    friend std::ostream &operator<<(std::ostream &os, const BasicOrder &o)
     {
         os << "id: " << o.get_id() << ", "
            << "level: " << o.get_level() << ", "
@@ -50,37 +80,60 @@ class Order
         return is_buy_;
     }
 
-    Id OrderId() const
+    I OrderId() const
     {
         return id_;
     }
 
     Side get_side() const noexcept
     {
-        return side_;
+        return is_buy_ ? Side::BUY : Side::SELL;
+    }
+
+    Type get_type() const noexcept
+    {
+        return type_;
+    }
+
+    /// @return True if an unfilled remainder goes on the book.
+    bool rests() const noexcept
+    {
+        return type_ == Type::LIMIT;
+    }
+
+    bool is_market() const noexcept
+    {
+        return type_ == Type::MARKET;
     }
 
-    Quantity get_qty() const
+    /// @return True if this order is willing to trade against `resting_level`.
+    bool crosses(P resting_level) const noexcept
+    {
+        return is_market() || (is_buy_ ? level_ >= resting_level : resting_level >= level_);
+    }
+
+    Q get_qty() const
     {
         return qty_;
     }
 
-    Id get_id() const
+    I get_id() const
     {
         return id_;
     }
 
-    Price get_level() const
+    P get_level() const
     {
         return level_;
     }
 
-    void set_qty(Quantity new_qty)
+    void set_qty(Q new_qty)
     {
-        qty_ = static_cast<Quantity>(new_qty);
+        qty_ = static_cast<Q>(new_qty);
     }
 };
 
+using Order = BasicOrder<Price, Quantity, Id>;
 using Orders = std::vector<Order>;
 
 // DO NOT MODIFY.
@@ -96,121 +149,627 @@ struct Trade
 
 using Trades = std::vector<Trade>;
 
-class Orderbook
+/// @brief Trade with the same fields as `Trade`, for books on other field
+/// types. The default book keeps reporting plain `Trade`.
+template <std::integral P, std::integral Q, std::unsigned_integral I> struct BasicTrade
+{
+    I OrderIdA;
+    I OrderIdB; // Aggressor's OrderId
+    I AggressorOrderId;
+    bool AggressorIsBuy;
+    P Level;
+    Q Size;
+};
+
+/// @brief Callable that receives trades as the book generates them. Passing
+/// one to `AddOrder` avoids building a `Trades` vector per call and lets the
+/// compiler inline whatever the caller does with each trade.
+template <class Sink, class T = Trade>
+concept TradeSink = std::invocable<Sink &, const T &>;
+
+namespace fiah
+{
+/// @brief One aggregated (L2) price level as published to market data.
+template <class P, class Q> struct BasicDepthLevel
+{
+    P price;
+    Q qty;
+    std::uint32_t count;
+};
+
+using DepthLevel = BasicDepthLevel<Price, Quantity>;
+
+/// @brief Where AddOrder spends its time, as recorded by a TscProbe.
+enum class MatchPhase : std::uint8_t
 {
-    Orders bids_{};
-    Orders asks_{};
+    DUPE_CHECK,   ///< Id index probe
+    SWEEP,        ///< Tick and FOK checks, then matching against the opposite side
+    LEVEL_SEARCH, ///< Finding the resting position of a remainder
+    INSERT,       ///< Shifting the side and adding the index entry
+    COUNT
+};
 
+constexpr std::string_view phase_name(MatchPhase phase) noexcept
+{
+    constexpr std::string_view names[]{"dupe_check", "sweep", "level_search", "insert"};
+    return names[std::to_underlying(phase)];
+}
+} // namespace fiah
+
+/// @brief Price-time priority book over its own price, quantity and id types.
+///
+/// Each side is one sorted array with the best order at the back. The id
+/// index makes dupe checks a single probe and holds each order's level and
+/// open quantity, so a cancel never touches the side: it drops the index
+/// entry, adjusts the level aggregate and records the id as a ghost. Ghosts
+/// stay in the array as tombstones until matching pops them off the back or
+/// a side that is more than half tombstones is compacted in one pass, which
+/// keeps cancels O(1) amortised however deep the book is.
+///
+/// @tparam TICK Price increment; limit prices off the grid are rejected on add
+/// and modify.
+/// @tparam MAX_DEPTH Resting orders per side. Zero keeps each side a growable
+/// std::vector; anything else stores the side inline in a fixed
+/// fiah::InplaceVector, and a remainder that finds its side full is dropped,
+/// as LadderOrderbook drops one outside its band.
+/// @tparam Probe fiah::NoProbe (no code, no space) or a
+/// fiah::TscProbe<fiah::MatchPhase> to histogram AddOrder per MatchPhase.
+template <std::integral P = Price, std::integral Q = Quantity, std::unsigned_integral I = Id, P TICK = 1,
+          std::size_t MAX_DEPTH = 0, class Probe = fiah::NoProbe>
+    requires(TICK > 0)
+class BasicOrderbook
+{
   public:
-    static constexpr inline std::uint64_t reserved_size_ = 20UL;
+    using order_type = BasicOrder<P, Q, I>;
+    using trade_type = std::conditional_t<std::is_same_v<order_type, Order>, Trade, BasicTrade<P, Q, I>>;
+    using trades_type = std::vector<trade_type>;
+    using depth_level_type = fiah::BasicDepthLevel<P, Q>;
+
+  private:
+    using side_type = std::conditional_t<MAX_DEPTH == 0, std::vector<order_type>,
+                                         fiah::InplaceVector<order_type, (MAX_DEPTH ? MAX_DEPTH : 1)>>;
+    // A side never has more levels than orders, so MAX_DEPTH bounds both
+    using levels_type = std::conditional_t<MAX_DEPTH == 0, std::vector<depth_level_type>,
+                                           fiah::InplaceVector<depth_level_type, (MAX_DEPTH ? MAX_DEPTH : 1)>>;
+
+    // Where a resting order lives and what is left of it: enough to take it
+    // off its level aggregate without finding it in the side
+    struct Locator
+    {
+        P level;
+        Q qty;
+        bool is_buy;
+    };
+
+    side_type bids_{};
+    side_type asks_{};
+    // Per-level qty and count, ordered like the sides (best level at the
+    // back), kept up to date by every mutation so depth reads never rescan
+    // the orders
+    levels_type bid_levels_{};
+    levels_type ask_levels_{};
+    fiah::FlatIdMap<I, Locator> index_{};
+    // Cancelled orders still sitting in a side. An entry is dead if its qty
+    // is zero (marked in place) or its id is here; an id is never live and a
+    // ghost at once, since rest_order() marks the ghost before reusing it
+    fiah::FlatIdMap<I, Locator> ghosts_{};
+    std::size_t dead_bids_{0};
+    std::size_t dead_asks_{0};
+    [[no_unique_address]] Probe probe_{};
 
-    Orderbook()
+  public:
+    static constexpr inline std::uint64_t reserved_size_ = MAX_DEPTH ? MAX_DEPTH : 20UL;
+    static constexpr inline P tick_size = TICK;
+    static constexpr inline std::size_t max_depth = MAX_DEPTH;
+    /// How far ahead AddOrders() prefetches, in orders.
+    static constexpr inline std::size_t PREFETCH_DISTANCE = 4;
+    /// The one id the index cannot hold; orders carrying it are dropped.
+    static constexpr inline I RESERVED_ID = fiah::FlatIdMap<I, Locator>::EMPTY_KEY;
+
+    BasicOrderbook()
     {
         bids_.reserve(reserved_size_);
         asks_.reserve(reserved_size_);
+        bid_levels_.reserve(reserved_size_);
+        ask_levels_.reserve(reserved_size_);
+        index_.reserve(2 * reserved_size_);
     }
 
-    bool can_match(const Order &buy, const Order &sell)
+    bool can_match(const order_type &buy, const order_type &sell)
     {
         return (buy.get_level() >= sell.get_level());
     }
 
-    bool is_dupe(const Order &order)
+    bool is_dupe(const order_type &order)
     {
-        auto is_match = [&order](Order &o) { return (o.get_id() == order.get_id()); };
+        return index_.contains(order.get_id());
+    }
 
-        return std::ranges::any_of(bids_, is_match) || std::ranges::any_of(asks_, is_match);
+    /// @return True if `price` is a multiple of the tick size.
+    static constexpr bool on_tick(P price) noexcept
+    {
+        if constexpr (TICK == 1)
+            return true;
+        else
+            return price % TICK == 0;
     }
 
-    void insert_order(const Order &order)
+    void insert_order(const order_type &order)
     {
-        if (is_dupe(order))
-            return;
-        if (order.is_buy())
-        {
-            // lower bound because we want to respect orders at the same
-            // price level that came first, and those should be closer to back
-            // so they get picked up first
-            auto pos = std::ranges::lower_bound(bids_, order.get_level(), std::less<Price>(), &Order::get_level);
-            bids_.insert(pos, order);
+        if (order.get_id() == RESERVED_ID || is_dupe(order) || !on_tick(order.get_level()))
             return;
-        }
-        auto pos = std::ranges::lower_bound(asks_, order.get_level(), std::greater<Price>(), &Order::get_level);
-        asks_.insert(pos, order);
+        rest_order(order, probe_.start());
+    }
+
+    /// @return The per-phase histograms; dump() them from any thread.
+    const Probe &probe() const noexcept
+    {
+        return probe_;
     }
 
     [[nodiscard]]
-    Trades AddOrder(const Order &incoming)
+    trades_type AddOrder(const order_type &incoming)
     {
-        Trades trades;
-        if (is_dupe(incoming))
-            return trades;
+        trades_type trades;
+        AddOrder(incoming, [&trades](const trade_type &trade) { trades.push_back(trade); });
+        return trades;
+    }
+
+    /// @brief Same matching as above, but each trade is handed to `sink` as
+    /// soon as it happens instead of being collected into a vector.
+    template <TradeSink<trade_type> Sink> void AddOrder(const order_type &incoming, Sink &&sink)
+    {
+        auto stamp = probe_.start();
+        const bool dupe = is_dupe(incoming);
+        stamp = probe_.lap(fiah::MatchPhase::DUPE_CHECK, stamp);
+        if (dupe || incoming.get_id() == RESERVED_ID)
+            return;
+        if (!incoming.is_market() && !on_tick(incoming.get_level()))
+            return;
+        if (incoming.get_type() == OrderType::FOK && !can_fill(incoming))
+            return;
 
         auto &opposite_side = incoming.is_buy() ? asks_ : bids_;
-        // auto& same_side     = incoming.is_buy() ? bids_ : asks_;
+        auto &opposite_levels = incoming.is_buy() ? ask_levels_ : bid_levels_;
 
-        Quantity remaining = incoming.get_qty();
+        Q remaining = incoming.get_qty();
 
         while (!opposite_side.empty() and remaining > 0)
         {
-            Order &best = opposite_side.back();
-            bool match = incoming.is_buy() ? can_match(incoming, best) : can_match(best, incoming);
-            if (!match)
+            order_type &best = opposite_side.back();
+            if (_is_dead(best)) [[unlikely]]
+            {
+                _pop_dead(opposite_side, !incoming.is_buy());
+                continue;
+            }
+            if (!incoming.crosses(best.get_level()))
                 break;
 
             // figure out how much qty from incoming we can trade
-            Quantity trade_size = std::min(best.get_qty(), remaining);
+            Q trade_size = std::min(best.get_qty(), remaining);
 
             // Price is ALWAYS from the ask (sell) side
             // If incoming is buy, best is sell (ask) - use best.get_level()
             // If incoming is sell, incoming is ask - use incoming.get_level()
-            Price trade_price = incoming.is_buy() ? best.get_level() : incoming.get_level();
+            // A market sell has no price of its own and takes the bid's
+            P trade_price = incoming.is_buy() || incoming.is_market() ? best.get_level() : incoming.get_level();
 
             // Determine aggressor: incoming is always the aggressor in this
             // matching model
-            Id aggressor_id = incoming.get_id();
+            I aggressor_id = incoming.get_id();
             bool aggressor_is_buy = incoming.is_buy();
 
             // Trade format: bid order first, then ask order
-            Id bid_order_id = incoming.is_buy() ? incoming.get_id() : best.get_id();
-            Id ask_order_id = incoming.is_buy() ? best.get_id() : incoming.get_id();
+            I bid_order_id = incoming.is_buy() ? incoming.get_id() : best.get_id();
+            I ask_order_id = incoming.is_buy() ? best.get_id() : incoming.get_id();
 
             // send trade since there is a match
-            trades.emplace_back(
-                Trade{bid_order_id, ask_order_id, aggressor_id, aggressor_is_buy, trade_price, trade_size});
+            sink(trade_type{bid_order_id, ask_order_id, aggressor_id, aggressor_is_buy, trade_price, trade_size});
 
-            // update quantities
-            best.set_qty(best.get_qty() - trade_size);
-            remaining -= trade_size;
+            // update quantities; the best order is on the best level
+            best.set_qty(static_cast<Q>(best.get_qty() - trade_size));
+            remaining = static_cast<Q>(remaining - trade_size);
+            depth_level_type &best_level = opposite_levels.back();
+            best_level.qty = static_cast<Q>(best_level.qty - trade_size);
 
             // get rid of fully-filled opposite-side order (remove last element)
             if (best.get_qty() == 0)
+            {
+                index_.erase(best.get_id());
                 opposite_side.pop_back();
+                if (--best_level.count == 0)
+                    opposite_levels.pop_back();
+            }
+            else // incoming is done; at most one partial fill per call
+                index_.find(best.get_id())->qty = best.get_qty();
         }
 
-        if (remaining > 0)
+        stamp = probe_.lap(fiah::MatchPhase::SWEEP, stamp);
+
+        if (remaining > 0 && incoming.rests())
         {
-            Order corrected_incoming = incoming;
+            order_type corrected_incoming = incoming;
             corrected_incoming.set_qty(remaining);
-            insert_order(corrected_incoming);
+            rest_order(corrected_incoming, stamp);
+        }
+    }
+
+    /// @return True if the opposite side holds enough crossing quantity to
+    /// fill `order` completely. Stops as soon as it has seen enough. Counts
+    /// down what is still needed rather than summing what is available, so
+    /// deep levels near Q's max cannot overflow.
+    bool can_fill(const order_type &order) const
+    {
+        const auto &opposite_levels = order.is_buy() ? ask_levels_ : bid_levels_;
+        Q needed = order.get_qty();
+        for (auto it = opposite_levels.rbegin(); it != opposite_levels.rend() && order.crosses(it->price); ++it)
+        {
+            if (it->qty >= needed)
+                return true;
+            needed = static_cast<Q>(needed - it->qty);
+        }
+        return false;
+    }
+
+    /// @brief Matches a batch in order; same results as one AddOrder each.
+    /// While one order is matched, the id-index slot of the order
+    /// PREFETCH_DISTANCE places ahead is already being pulled into cache.
+    template <TradeSink<trade_type> Sink> void AddOrders(std::span<const order_type> orders, Sink &&sink)
+    {
+        const std::size_t n = orders.size();
+        for (std::size_t i = 0; i < std::min(n, PREFETCH_DISTANCE); ++i)
+            index_.prefetch(orders[i].get_id());
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (i + PREFETCH_DISTANCE < n)
+                index_.prefetch(orders[i + PREFETCH_DISTANCE].get_id());
+            AddOrder(orders[i], sink);
         }
+    }
+
+    /// @brief Removes a resting order without searching or shifting its
+    /// side: O(1) amortised plus the level-aggregate lookup. Unknown ids are
+    /// ignored.
+    void CancelOrder(I order_id)
+    {
+        const Locator *loc = index_.find(order_id);
+        if (!loc)
+            return;
+
+        const Locator gone = *loc;
+        index_.erase(order_id);
+        ghosts_.insert(order_id, gone);
+        _level_remove(gone.is_buy, gone.level, gone.qty, true);
+        _bury(gone.is_buy);
+    }
+
+    [[nodiscard]]
+    trades_type ModifyOrder(I order_id, Q new_qty, P new_price)
+    {
+        trades_type trades;
+        ModifyOrder(order_id, new_qty, new_price, [&trades](const trade_type &trade) { trades.push_back(trade); });
         return trades;
     }
 
-    void CancelOrder(Id order_id)
+    /// @brief Amends a resting order. Shrinking at the same price is done in
+    /// place and keeps queue priority; a price change or size increase
+    /// re-queues the order as an aggressor, so it may trade. A non-positive
+    /// quantity cancels. Unknown ids and off-tick prices are ignored.
+    template <TradeSink<trade_type> Sink> void ModifyOrder(I order_id, Q new_qty, P new_price, Sink &&sink)
     {
-        auto id_match = [=](const Order &o) { return o.get_id() == order_id; };
-        auto bid_it = std::ranges::find_if(bids_, id_match);
-        if (bid_it != std::end(bids_))
+        Locator *loc = index_.find(order_id);
+        if (!loc || (new_qty > 0 && !on_tick(new_price)))
+            return;
+
+        auto &side = loc->is_buy ? bids_ : asks_;
+        auto id_match = [=](const order_type &o) { return o.get_id() == order_id && o.get_qty() != 0; };
+        auto level_run = loc->is_buy
+                             ? std::ranges::equal_range(side, loc->level, std::less<P>(), &order_type::get_level)
+                             : std::ranges::equal_range(side, loc->level, std::greater<P>(), &order_type::get_level);
+        auto it = std::ranges::find_if(level_run, id_match);
+
+        if (new_qty > 0 && new_price == it->get_level() && new_qty <= it->get_qty())
         {
-            bids_.erase(bid_it);
+            _level_remove(loc->is_buy, loc->level, static_cast<Q>(it->get_qty() - new_qty), false);
+            it->set_qty(new_qty);
+            loc->qty = new_qty;
             return;
         }
-        auto asks_it = std::ranges::find_if(asks_, id_match);
-        if (asks_it != std::end(asks_))
+
+        // Leave a marked tombstone rather than shifting the side
+        const bool is_buy = it->is_buy();
+        _level_remove(is_buy, loc->level, it->get_qty(), true);
+        it->set_qty(0);
+        index_.erase(order_id);
+        _bury(is_buy);
+        if (new_qty > 0)
+            AddOrder(order_type{order_id, new_price, is_buy, new_qty}, sink);
+    }
+
+    /// @return Resting orders on both sides.
+    std::size_t size() const noexcept
+    {
+        return index_.size();
+    }
+
+    /// @brief Copies up to `out.size()` best levels of one side, best first,
+    /// from the maintained per-level aggregates: O(levels copied), however
+    /// many orders rest on them.
+    /// @return Number of levels written.
+    std::size_t top_levels(OrderSide side, std::span<depth_level_type> out) const noexcept
+    {
+        const auto &levels = side == OrderSide::BUY ? bid_levels_ : ask_levels_;
+        const std::size_t n = std::min(out.size(), levels.size());
+        std::copy_n(levels.rbegin(), n, out.begin());
+        return n;
+    }
+
+    /// @brief Writes both sides to `path` as a position-independent image
+    /// (the sides hold no pointers to begin with). Orders go out as
+    /// OrderImage records, so the file holds no padding bytes and the same
+    /// book always produces the same image.
+    /// @param journal_seq Last journal sequence number reflected in the book.
+    auto save_snapshot(const std::string &path, std::uint64_t journal_seq = 0) const
+        -> std::expected<void, fiah::FileError>
+    {
+        auto writer = fiah::ImageWriter::create(path, sizeof(ImageHeader));
+        if (!writer)
+            return std::unexpected(writer.error());
+        auto bids = writer->append(std::span<const OrderImage>{_to_images(bids_)});
+        auto asks = writer->append(std::span<const OrderImage>{_to_images(asks_)});
+        if (!bids || !asks)
+            return std::unexpected(fiah::FileError::WRITE_FAIL);
+        return writer->commit(ImageHeader{.journal_seq = journal_seq, .bids = *bids, .asks = *asks});
+    }
+
+    /// @brief Rebuilds a book from save_snapshot() output: one pass over
+    /// each side that restores the orders, their levels and the id index.
+    /// Every order is checked on the way in, since the book's invariants are
+    /// what keep CancelOrder() and ModifyOrder() in bounds.
+    /// @return BAD_RECORD for an order on the wrong side, out of price-time
+    /// order, crossing the other side, with a non-positive qty, an off-tick
+    /// price, a non-LIMIT type, a value its field type cannot hold, or a
+    /// reserved or repeated id.
+    /// @param journal_seq If set, receives the sequence number passed to
+    /// save_snapshot().
+    static auto restore_snapshot(const std::string &path, std::uint64_t *journal_seq = nullptr)
+        -> std::expected<BasicOrderbook, fiah::FileError>
+    {
+        auto reader = fiah::ImageReader::open(path);
+        if (!reader)
+            return std::unexpected(reader.error());
+        auto header = reader->header<ImageHeader>();
+        if (!header)
+            return std::unexpected(header.error());
+        if (header->magic != ImageHeader::MAGIC || header->version != ImageHeader::VERSION ||
+            header->order_size != sizeof(OrderImage))
+            return std::unexpected(fiah::FileError::BAD_HEADER);
+
+        auto bids = reader->section<OrderImage>(header->bids);
+        auto asks = reader->section<OrderImage>(header->asks);
+        if (!bids || !asks)
+            return std::unexpected(fiah::FileError::TRUNCATED);
+        if constexpr (MAX_DEPTH != 0)
+            if (bids->size() > MAX_DEPTH || asks->size() > MAX_DEPTH)
+                return std::unexpected(fiah::FileError::BAD_HEADER);
+
+        BasicOrderbook book;
+        book.index_.reserve(bids->size() + asks->size());
+        for (const auto &[images, side] : {std::pair{*bids, &book.bids_}, std::pair{*asks, &book.asks_}})
         {
-            asks_.erase(asks_it);
-            return;
+            const bool is_buy = side == &book.bids_;
+            for (const OrderImage &img : images)
+            {
+                if (img.is_buy != (is_buy ? 1 : 0) || img.type != std::to_underlying(OrderType::LIMIT) ||
+                    !std::in_range<I>(img.id) || !std::in_range<P>(img.level) || !std::in_range<Q>(img.qty) ||
+                    std::cmp_less_equal(img.qty, 0) || !on_tick(static_cast<P>(img.level)))
+                    return std::unexpected(fiah::FileError::BAD_RECORD);
+                // Best at the back: bids ascend, asks descend
+                const auto level = static_cast<P>(img.level);
+                if (!side->empty() && (is_buy ? level < side->back().get_level() : level > side->back().get_level()))
+                    return std::unexpected(fiah::FileError::BAD_RECORD);
+
+                const order_type order{static_cast<I>(img.id), level, is_buy, static_cast<Q>(img.qty)};
+                if (order.get_id() == RESERVED_ID ||
+                    !book.index_.insert(order.get_id(), Locator{order.get_level(), order.get_qty(), order.is_buy()}))
+                    return std::unexpected(fiah::FileError::BAD_RECORD);
+                side->push_back(order);
+                book._level_add(order.is_buy(), order.get_level(), order.get_qty());
+            }
         }
+        if (!book.bids_.empty() && !book.asks_.empty() &&
+            book.bids_.back().get_level() >= book.asks_.back().get_level())
+            return std::unexpected(fiah::FileError::BAD_RECORD);
+        if (journal_seq)
+            *journal_seq = header->journal_seq;
+        return book;
+    }
+
+  private:
+    struct ImageHeader
+    {
+        static constexpr std::uint64_t MAGIC{0x4B4F'4256'4841'4946ULL}; // "FIAHVBOK"
+        // 2: carries journal_seq, 3: order_size, 4: OrderImage records, no index,
+        // 5: order_size is the record size
+        static constexpr std::uint32_t VERSION{5};
+
+        std::uint64_t magic{MAGIC};
+        std::uint32_t version{VERSION};
+        std::uint32_t order_size{sizeof(OrderImage)};
+        std::uint64_t journal_seq{0};
+        fiah::ImageSection bids;
+        fiah::ImageSection asks;
+    };
+
+    template <class T> using image_int_t = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;
+
+    // An order widened to fixed-size fields with the padding spelled out, so
+    // every byte written is initialised whatever P, Q and I are
+    struct OrderImage
+    {
+        std::uint64_t id;
+        image_int_t<P> level;
+        image_int_t<Q> qty;
+        std::uint8_t is_buy;
+        std::uint8_t type;
+        std::uint8_t pad[6]{};
+    };
+    static_assert(std::has_unique_object_representations_v<OrderImage>);
+
+    std::vector<OrderImage> _to_images(const side_type &side) const
+    {
+        std::vector<OrderImage> images;
+        images.reserve(side.size());
+        for (const order_type &order : side)
+            if (!_is_dead(order))
+                images.push_back(OrderImage{order.get_id(), order.get_level(), order.get_qty(), order.is_buy(),
+                                        static_cast<std::uint8_t>(order.get_type())});
+        return images;
     }
+
+    /// @pre !is_dupe(order)
+    void rest_order(const order_type &order, typename Probe::Stamp stamp)
+    {
+        auto &side = order.is_buy() ? bids_ : asks_;
+        if (!ghosts_.empty()) [[unlikely]]
+            _mark_ghost(order.get_id());
+        if constexpr (MAX_DEPTH != 0)
+            if (side.full())
+            {
+                if (_dead_count(order.is_buy()) == 0)
+                    return;
+                _compact(order.is_buy());
+            }
+
+        // lower bound because we want to respect orders at the same
+        // price level that came first, and those should be closer to back
+        // so they get picked up first
+        auto pos = order.is_buy()
+                       ? std::ranges::lower_bound(side, order.get_level(), std::less<P>(), &order_type::get_level)
+                       : std::ranges::lower_bound(side, order.get_level(), std::greater<P>(), &order_type::get_level);
+        stamp = probe_.lap(fiah::MatchPhase::LEVEL_SEARCH, stamp);
+        side.insert(pos, order);
+        _level_add(order.is_buy(), order.get_level(), order.get_qty());
+        index_.insert(order.get_id(), Locator{order.get_level(), order.get_qty(), order.is_buy()});
+        probe_.lap(fiah::MatchPhase::INSERT, stamp);
+    }
+
+    /// True for a tombstone: marked in place, or a cancel still in ghosts_.
+    bool _is_dead(const order_type &order) const noexcept
+    {
+        return order.get_qty() == 0 || (!ghosts_.empty() && ghosts_.contains(order.get_id()));
+    }
+
+    std::size_t &_dead_count(bool is_buy) noexcept
+    {
+        return is_buy ? dead_bids_ : dead_asks_;
+    }
+
+    /// @pre _is_dead(side.back())
+    void _pop_dead(side_type &side, bool is_buy) noexcept
+    {
+        if (side.back().get_qty() != 0)
+            ghosts_.erase(side.back().get_id());
+        side.pop_back();
+        --_dead_count(is_buy);
+    }
+
+    /// Counts a new tombstone and compacts its side once tombstones
+    /// outnumber live orders there, so each pass is paid for by the cancels
+    /// that made it necessary.
+    void _bury(bool is_buy)
+    {
+        const auto &side = is_buy ? bids_ : asks_;
+        if (++_dead_count(is_buy) * 2 > side.size())
+            _compact(is_buy);
+    }
+
+    /// Drops every tombstone from one side in a single stable pass.
+    void _compact(bool is_buy) noexcept
+    {
+        auto &side = is_buy ? bids_ : asks_;
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < side.size(); ++i)
+        {
+            const order_type order = side[i];
+            if (order.get_qty() == 0 || (!ghosts_.empty() && ghosts_.erase(order.get_id())))
+                continue;
+            side[kept++] = order;
+        }
+        while (side.size() > kept)
+            side.pop_back();
+        _dead_count(is_buy) = 0;
+    }
+
+    /// An id is being reused while its cancelled order is still in a side:
+    /// find that tombstone (one level scan, rare) and mark it in place so the
+    /// id stops meaning "dead".
+    void _mark_ghost(I order_id) noexcept
+    {
+        const Locator *ghost = ghosts_.find(order_id);
+        if (!ghost)
+            return;
+        auto &side = ghost->is_buy ? bids_ : asks_;
+        auto level_run = ghost->is_buy
+                             ? std::ranges::equal_range(side, ghost->level, std::less<P>(), &order_type::get_level)
+                             : std::ranges::equal_range(side, ghost->level, std::greater<P>(), &order_type::get_level);
+        auto it = std::ranges::find_if(
+            level_run, [=](const order_type &o) { return o.get_id() == order_id && o.get_qty() != 0; });
+        it->set_qty(0);
+        ghosts_.erase(order_id);
+    }
+
+    /// Position of `price` in one side's levels, or where it would go.
+    auto _find_level(levels_type &levels, bool is_buy, P price) noexcept
+    {
+        return is_buy ? std::ranges::lower_bound(levels, price, std::less<P>(), &depth_level_type::price)
+                      : std::ranges::lower_bound(levels, price, std::greater<P>(), &depth_level_type::price);
+    }
+
+    /// Counts a newly resting order into its level, creating the level.
+    void _level_add(bool is_buy, P price, Q qty)
+    {
+        auto &levels = is_buy ? bid_levels_ : ask_levels_;
+        auto it = _find_level(levels, is_buy, price);
+        if (it == levels.end() || it->price != price)
+            it = levels.insert(it, depth_level_type{price, 0, 0});
+        it->qty = static_cast<Q>(it->qty + qty);
+        ++it->count;
+    }
+
+    /// Takes `qty` off an existing level and, if `removed`, one order,
+    /// dropping the level when its last order goes.
+    void _level_remove(bool is_buy, P price, Q qty, bool removed) noexcept
+    {
+        auto &levels = is_buy ? bid_levels_ : ask_levels_;
+        auto it = _find_level(levels, is_buy, price);
+        it->qty = static_cast<Q>(it->qty - qty);
+        if (removed && --it->count == 0)
+            levels.erase(it);
+    }
+};
+
+using Orderbook = BasicOrderbook<>;
+
+/// @brief Orderbook with AddOrder phase histograms compiled in.
+using ProbedOrderbook = BasicOrderbook<Price, Quantity, Id, 1, 0, fiah::TscProbe<fiah::MatchPhase>>;
+
+/// @brief 32-bit fields on a fixed `MAX_DEPTH` orders per side: 16-byte orders,
+/// four to a cache line, and no allocation after construction.
+template <std::int32_t TICK = 1, std::size_t MAX_DEPTH = 256>
+using CompactOrderbook = BasicOrderbook<std::int32_t, std::int32_t, std::uint32_t, TICK, MAX_DEPTH>;
+
+static_assert(sizeof(Order) == 24);
+static_assert(sizeof(CompactOrderbook<>::order_type) == 16);
+
+/// @brief Anything that can stand in for `Orderbook`: same entry points, same
+/// trade reporting. Lets callers and tests pick the book implementation.
+template <class Book>
+concept OrderbookLike = requires(Book &book, const Order &order, Id id) {
+    { book.AddOrder(order) } -> std::same_as<Trades>;
+    { book.is_dupe(order) } -> std::convertible_to<bool>;
+    book.CancelOrder(id);
+    { book.ModifyOrder(id, Quantity{}, Price{}) } -> std::same_as<Trades>;
 };
+
+static_assert(OrderbookLike<Orderbook>);
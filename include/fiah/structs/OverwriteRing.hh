@@ -0,0 +1,155 @@
+#pragma once
+
+// C++ Includes
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+// FastInAHurry Includes
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Lossy single-producer, single-consumer ring: push() never fails and
+/// never waits. When the consumer falls more than a ring behind, the oldest
+/// entries are overwritten, and the consumer finds out how many it lost from
+/// the entries' sequence numbers. For market-data fan-out, where a stale
+/// update is worth less than a blocked producer.
+///
+/// Each slot is a sequence lock: entry n is written between slot sequence
+/// 2n + 1 and 2n + 2. The consumer reads the slot of the entry it wants next
+/// and, from the sequence alone, knows whether that entry is there, not yet
+/// written, or already overwritten; it only reads the producer's index when
+/// it was lapped, to jump to the oldest entry still in the ring. Payloads are
+/// relaxed atomic words, as in SeqLock, so a copy the consumer throws away is
+/// not a data race.
+///
+/// Unlike SPSCQueue the producer never looks at the consumer, so there is no
+/// back-pressure and no cross-core read on the push path.
+///
+/// @attention One producer thread and one consumer thread.
+/// @tparam CapacityPow2 Entries kept before the oldest is overwritten.
+template <class T, u64_t CapacityPow2>
+    requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> &&
+             (CapacityPow2 > 0 && (CapacityPow2 & (CapacityPow2 - 1)) == 0)
+class OverwriteRing
+{
+  public:
+    OverwriteRing() = default;
+    OverwriteRing(const OverwriteRing &) = delete;
+    OverwriteRing &operator=(const OverwriteRing &) = delete;
+
+    static constexpr u64_t capacity() noexcept
+    {
+        return CapacityPow2;
+    }
+
+    /// @brief Writes `value` as the next entry, overwriting the oldest one if
+    /// the ring is full.
+    void push(const T &value) noexcept
+    {
+        const u64_t n = m_head.load(std::memory_order_relaxed);
+        Slot &slot = _slot(n);
+        slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        u64_t words[WORDS]{};
+        std::memcpy(words, &value, sizeof(T));
+        for (sz_t i = 0; i < WORDS; ++i)
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        slot.seq.store(2 * n + 2, std::memory_order_release);
+        m_head.store(n + 1, std::memory_order_release);
+    }
+
+    /// @brief Copies out the next entry, skipping any that were overwritten
+    /// before they could be read.
+    /// @param seq Set to the entry's sequence number (0 for the first push);
+    /// a jump of more than one from the previous pop is the number lost.
+    /// @return False if there is nothing new.
+    bool pop(T &out, u64_t &seq) noexcept
+    {
+        for (;;)
+        {
+            const Slot &slot = _slot(m_next);
+            const u64_t want = 2 * m_next + 2;
+            const u64_t before = slot.seq.load(std::memory_order_acquire);
+            if (before < want) // not written yet, or being written
+                return false;
+            if (before == want)
+            {
+                u64_t words[WORDS];
+                for (sz_t i = 0; i < WORDS; ++i)
+                    words[i] = slot.words[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) == want)
+                {
+                    std::memcpy(&out, words, sizeof(T));
+                    seq = m_next++;
+                    return true;
+                }
+            }
+            // Lapped, before or during the copy: entry m_next is gone. Jump
+            // to the oldest one the producer has not started to overwrite.
+            const u64_t head = m_head.load(std::memory_order_acquire);
+            const u64_t oldest = std::max(m_next + 1, head > CapacityPow2 ? head - CapacityPow2 : 0);
+            m_lost += oldest - m_next;
+            m_next = oldest;
+        }
+    }
+
+    bool pop(T &out) noexcept
+    {
+        u64_t seq;
+        return pop(out, seq);
+    }
+
+    /// @brief Entries pushed so far. Any thread.
+    [[nodiscard]] u64_t pushed() const noexcept
+    {
+        return m_head.load(std::memory_order_acquire);
+    }
+
+    /// @brief Entries overwritten before the consumer got to them. Consumer
+    /// thread only.
+    [[nodiscard]] u64_t lost() const noexcept
+    {
+        return m_lost;
+    }
+
+    /// @brief Sequence number the next pop() asks for. Consumer thread only.
+    [[nodiscard]] u64_t next_seq() const noexcept
+    {
+        return m_next;
+    }
+
+  private:
+    static constexpr sz_t WORDS{(sizeof(T) + sizeof(u64_t) - 1) / sizeof(u64_t)};
+    static constexpr u64_t kMask{CapacityPow2 - 1};
+
+    // A slot per line: the producer writing entry n + 1 does not invalidate
+    // the line the consumer is copying entry n out of
+    struct alignas(cacheline_t::value) Slot
+    {
+        std::atomic<u64_t> seq{0};
+        std::atomic<u64_t> words[WORDS]{};
+    };
+
+    Slot &_slot(u64_t n) noexcept
+    {
+        return m_slots[n & kMask];
+    }
+
+    const Slot &_slot(u64_t n) const noexcept
+    {
+        return m_slots[n & kMask];
+    }
+
+    alignas(cacheline_t::value) std::atomic<u64_t> m_head{0}; // written by producer
+    alignas(cacheline_t::value) u64_t m_next{0};              // consumer-private
+    u64_t m_lost{0};                                          // consumer-private
+    Slot m_slots[CapacityPow2];
+};
+
+} // End namespace fiah
@@ -3,94 +3,79 @@
 // C++ Includes
 #include <x86intrin.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <new>
+#include <span>
 #include <type_traits>
 #include <utility>
 #include <concepts>
 
 // FastInAHurry Includes
+#include "fiah/utils/CacheLine.hh"
 
 namespace fiah
 {
 
-#if defined(__cpp_lib_hardware_interference_size)
-#if defined(__GNUC__) && !defined(__clang__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Winterference-size"
-#endif
-using cacheline_t = std::integral_constant<std::uint64_t, std::hardware_destructive_interference_size>;
-#if defined(__GNUC__) && !defined(__clang__)
-#pragma GCC diagnostic pop
-#endif
-#else
-constexpr std::uint16_t CACHE_LINE_SIZE_BYTES{64};
-using cacheline_t = std::integral_constant<std::uint64_t, CACHE_LINE_SIZE_BYTES>;
-#endif
-
-/// @brief  Lock free single-producer, single-consumer queue (constexpr
-/// constructed)
-/// @attention Not liable for damages if you have more than ONE
-/// consumer/producer
-///            pair of threads accessing this queue. Undefined behavior, data
-///            races, all the good things...
-/// @tparam T No array types pls
-/// @tparam CapacityPow2 Capacity should be power of two for logical indexing
-///
-/// @todo I should make it so that old values are overwritten
-/// @todo Maintain pointers (handles) to preallocated buckets for
-/// pre-constructed
-///       slots (instead of doing malloc and placement new on every push).
-/// @todo Use `tcmalloc` instead
-/// @example spsc_queue_example.cc
-template <class T, std::uint64_t CapacityPow2> class SPSCQueue
+namespace detail
 {
-    // static_assert(!std::is_array_v<T>, "SPSCQueue does not support array element types");
-    static_assert((CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be a power of two");
-    static constexpr std::uint64_t kCapacity = CapacityPow2;
-    static constexpr std::uint64_t kMask = kCapacity - 1;
+/// Ring storage inline in the queue object, capacity fixed at compile time.
+template <class T, std::uint64_t Capacity> struct InlineRing
+{
+    using element_type = std::remove_extent_t<T>;
 
-    alignas(cacheline_t::value) std::atomic<std::uint64_t> m_head{0}; // written by producer, read by consumer
-    alignas(cacheline_t::value) std::atomic<std::uint64_t> m_tail{0}; // written by consumer, read by producer
+    static constexpr std::uint64_t capacity() noexcept
+    {
+        return Capacity;
+    }
 
+    static constexpr std::uint64_t mask() noexcept
+    {
+        return Capacity - 1;
+    }
 
+    element_type *slot(std::uint64_t idx) noexcept
+    {
+        return std::launder(reinterpret_cast<element_type *>(bytes + (idx & mask()) * sizeof(T)));
+    }
 
     // Ensure storage is aligned both to cache-line boundaries (for
     // padding/padding avoidance) and to the element alignment so placement-new
     // on T is safe.
-    alignas(cacheline_t::value) alignas(alignof(T)) std::byte m_storage[kCapacity * sizeof(T)];
+    alignas(cacheline_t::value) alignas(alignof(T)) std::byte bytes[Capacity * sizeof(T)];
+};
+} // namespace detail
 
+/// @brief The single-producer, single-consumer protocol, whatever holds the
+/// ring. `Ring` only supplies slots: capacity() (a power of two), mask() and
+/// slot(idx), the element at `idx & mask()`. Indices, the cached copies of
+/// the other side's index and every operation live here, so SPSCQueue and
+/// MappedSPSCQueue differ only in where their storage is.
+/// @attention One producer thread and one consumer thread.
+template <class T, class Ring> class BasicSPSCQueue
+{
     using ElementT = std::remove_extent_t<T>;
-    static ElementT* slot_ptr(std::byte *base, std::uint64_t idx) noexcept
-    {
-        return std::launder(reinterpret_cast<ElementT*>(base + (idx & kMask) * sizeof(T)));
-    }
 
+    alignas(cacheline_t::value) std::atomic<std::uint64_t> m_head{0}; // written by producer, read by consumer
+    alignas(cacheline_t::value) std::atomic<std::uint64_t> m_tail{0}; // written by consumer, read by producer
 
-  public:
+    // Each side's last look at the other's index, on a line only that side
+    // touches. The producer only reloads m_tail when the cached copy says
+    // full, the consumer only reloads m_head when its copy says empty, so a
+    // queue that is neither costs no cross-core reads of the other's line.
+    alignas(cacheline_t::value) std::uint64_t m_tail_cache{0}; // producer-private
+    alignas(cacheline_t::value) std::uint64_t m_head_cache{0}; // consumer-private
 
-    constexpr SPSCQueue() = default;
-    SPSCQueue(const SPSCQueue &) = delete;
-    SPSCQueue &operator=(const SPSCQueue &) = delete;
+    // Written once, then only read by both sides
+    alignas(cacheline_t::value) Ring m_ring;
 
-    ~SPSCQueue()
-    {
-        // Drain any constructed-but-not-popped elements to run destructors.
-        // NOTE: destructor assumes no other threads are concurrently using the
-        // queue. Calling the destructor while producer/consumer are active is
-        // undefined behavior. We use acquire loads to ensure we observe the
-        // latest published head/tail if called during shutdown synchronization.
-        auto tail = m_tail.load(std::memory_order_acquire);
-        auto head = m_head.load(std::memory_order_acquire);
-        while (tail != head)
-        {
-            std::destroy_at(slot_ptr(m_storage, tail));
-            ++tail;
-        }
-    }
+  public:
+    BasicSPSCQueue(const BasicSPSCQueue &) = delete;
+    BasicSPSCQueue &operator=(const BasicSPSCQueue &) = delete;
 
     /// @param x
     /// @return Success or failure as a bool.
@@ -108,14 +93,18 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
     {
         // Producer thread only mutates m_head
         std::uint64_t head = m_head.load(std::memory_order_relaxed);
-        // Read consumer's tail with acquire to observe element reclamation
-        std::uint64_t tail = m_tail.load(std::memory_order_acquire);
 
-        // Full if producer is kCapacity ahead of consumer
-        if ((head - tail) == kCapacity) [[unlikely]]
-            return false;
+        // Full if producer is capacity() ahead of consumer. The cached tail
+        // can only be behind, so it never claims room that isn't there
+        if ((head - m_tail_cache) == m_ring.capacity()) [[unlikely]]
+        {
+            // Read consumer's tail with acquire to observe element reclamation
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if ((head - m_tail_cache) == m_ring.capacity())
+                return false;
+        }
 
-        T *p = slot_ptr(m_storage, head);
+        T *p = m_ring.slot(head);
         std::construct_at(p, std::forward<Args>(args)...);
 
         // Publish the new element: release pairs with consumer's acquire
@@ -127,12 +116,17 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
     bool pop(T &out)
     {
         std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
-        std::uint64_t head = m_head.load(std::memory_order_acquire);
 
-        if (head == tail) [[unlikely]]
-            return false; // empty
+        // Everything below the cached head was published by an earlier
+        // acquire, so only an apparently empty queue needs a fresh look
+        if (m_head_cache == tail) [[unlikely]]
+        {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            if (m_head_cache == tail)
+                return false; // empty
+        }
 
-        ElementT *p = slot_ptr(m_storage, tail);
+        ElementT *p = m_ring.slot(tail);
         if constexpr (std::is_array_v<T>)
         {
             for (auto i{0uz}; i < sizeof(T); ++i)
@@ -148,6 +142,111 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
         return true;
     }
 
+    /// @brief Producer side of a zero-copy push: default-initializes the next
+    /// element in place and hands it out to be filled in.
+    /// @return nullptr if the queue is full.
+    /// @attention A non-null result must be followed by commit() before the
+    /// next try_reserve()/push(); until then the consumer cannot see it.
+    T *try_reserve() noexcept(std::is_nothrow_default_constructible_v<T>)
+        requires(!std::is_array_v<T> && std::default_initializable<T>)
+    {
+        const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        if ((head - m_tail_cache) == m_ring.capacity()) [[unlikely]]
+        {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if ((head - m_tail_cache) == m_ring.capacity())
+                return nullptr;
+        }
+        return ::new (static_cast<void *>(m_ring.slot(head))) T;
+    }
+
+    /// @brief Publishes the element handed out by try_reserve().
+    void commit() noexcept
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /// @brief Consumer side of a zero-copy pop: the oldest element, still in
+    /// its slot.
+    /// @return nullptr if the queue is empty. Valid until release().
+    const T *front() noexcept
+        requires(!std::is_array_v<T>)
+    {
+        const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_head_cache == tail) [[unlikely]]
+        {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            if (m_head_cache == tail)
+                return nullptr;
+        }
+        return m_ring.slot(tail);
+    }
+
+    /// @brief Destroys the element returned by front() and hands its slot
+    /// back to the producer.
+    /// @pre front() returned non-null since the last release()/pop().
+    void release() noexcept
+    {
+        const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        std::destroy_at(m_ring.slot(tail));
+        m_tail.store(tail + 1, std::memory_order_release);
+    }
+
+    /// @brief Copies as many of `items` as fit, in at most two contiguous
+    /// runs around the wrap point, and publishes them all with one release
+    /// store.
+    /// @return Number of elements pushed; 0 if the queue is full.
+    std::size_t push_bulk(std::span<const T> items)
+        requires(!std::is_array_v<T>)
+    {
+        const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        std::uint64_t room = m_ring.capacity() - (head - m_tail_cache);
+        if (room < items.size())
+        {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            room = m_ring.capacity() - (head - m_tail_cache);
+        }
+        const std::uint64_t n = std::min<std::uint64_t>(room, items.size());
+        if (n == 0)
+            return 0;
+
+        const std::uint64_t first = std::min(n, m_ring.capacity() - (head & m_ring.mask()));
+        std::uninitialized_copy_n(items.data(), first, m_ring.slot(head));
+        std::uninitialized_copy_n(items.data() + first, n - first, m_ring.slot(0));
+
+        m_head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /// @brief Moves up to `out.size()` elements into `out`, in at most two
+    /// contiguous runs, and frees their slots with one release store.
+    /// @return Number of elements popped; 0 if the queue is empty.
+    std::size_t pop_bulk(std::span<T> out)
+        requires(!std::is_array_v<T>)
+    {
+        const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        std::uint64_t available = m_head_cache - tail;
+        if (available < out.size())
+        {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            available = m_head_cache - tail;
+        }
+        const std::uint64_t n = std::min<std::uint64_t>(available, out.size());
+        if (n == 0)
+            return 0;
+
+        auto move_out = [](T *from, std::uint64_t count, T *to) {
+            std::move(from, from + count, to);
+            std::destroy_n(from, count);
+        };
+        const std::uint64_t first = std::min(n, m_ring.capacity() - (tail & m_ring.mask()));
+        move_out(m_ring.slot(tail), first, out.data());
+        move_out(m_ring.slot(0), n - first, out.data() + first);
+
+        m_tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
     bool empty() const noexcept
     {
         // Acquire not strictly required here for SPSC fast-path introspection,
@@ -161,7 +260,7 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
     {
         auto head = m_head.load(std::memory_order_relaxed);
         auto tail = m_tail.load(std::memory_order_acquire);
-        return (head - tail) == kCapacity;
+        return (head - tail) == m_ring.capacity();
     }
 
     std::uint64_t size() const noexcept
@@ -171,9 +270,68 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
         return head - tail;
     }
 
+    std::uint64_t capacity() const noexcept
+    {
+        return m_ring.capacity();
+    }
+
+  protected:
+    constexpr BasicSPSCQueue() = default;
+
+    explicit BasicSPSCQueue(Ring ring) noexcept : m_ring{std::move(ring)}
+    {
+    }
+
+    ~BasicSPSCQueue()
+    {
+        // Drain any constructed-but-not-popped elements to run destructors.
+        // NOTE: destructor assumes no other threads are concurrently using the
+        // queue. Calling the destructor while producer/consumer are active is
+        // undefined behavior. We use acquire loads to ensure we observe the
+        // latest published head/tail if called during shutdown synchronization.
+        auto tail = m_tail.load(std::memory_order_acquire);
+        auto head = m_head.load(std::memory_order_acquire);
+        while (tail != head)
+        {
+            std::destroy_at(m_ring.slot(tail));
+            ++tail;
+        }
+    }
+
+    const Ring &ring() const noexcept
+    {
+        return m_ring;
+    }
+};
+
+/// @brief  Lock free single-producer, single-consumer queue (constexpr
+/// constructed)
+/// @attention Not liable for damages if you have more than ONE
+/// consumer/producer
+///            pair of threads accessing this queue. Undefined behavior, data
+///            races, all the good things...
+/// @tparam T No array types pls
+/// @tparam CapacityPow2 Capacity should be power of two for logical indexing
+///
+/// @see OverwriteRing for a lossy variant that overwrites old values
+/// @see MappedSPSCQueue for the same protocol on a runtime-sized mapped ring
+/// @todo Maintain pointers (handles) to preallocated buckets for
+/// pre-constructed
+///       slots (instead of doing malloc and placement new on every push).
+/// @todo Use `tcmalloc` instead
+/// @example spsc_queue_example.cc
+template <class T, std::uint64_t CapacityPow2>
+class SPSCQueue : public BasicSPSCQueue<T, detail::InlineRing<T, CapacityPow2>>
+{
+    // static_assert(!std::is_array_v<T>, "SPSCQueue does not support array element types");
+    static_assert((CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be a power of two");
+
+  public:
+    constexpr SPSCQueue() = default;
+
     static constexpr std::uint64_t capacity() noexcept
     {
-        return kCapacity;
+        return CapacityPow2;
     }
 };
 
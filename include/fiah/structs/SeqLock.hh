@@ -0,0 +1,108 @@
+#pragma once
+
+// C++ Includes
+#include <x86intrin.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// FastInAHurry Includes
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Single-writer, multi-reader sequence lock around a small trivially
+/// copyable value.
+///
+/// The writer bumps the sequence to odd, stores the value and bumps it back to
+/// even. Readers copy the value between two loads of the sequence and retry if
+/// it was odd or moved. Readers never write anything shared, so any number of
+/// them can poll from other cores without bouncing the cache line away from
+/// the writer; the writer never waits on a reader.
+///
+/// The payload is held as relaxed atomic words rather than a plain T, so the
+/// racing copy a reader may throw away is not a data race; on x86 each word is
+/// still a plain mov.
+///
+/// @attention store() must only ever be called from one thread.
+template <class T>
+    requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+class SeqLock
+{
+  public:
+    SeqLock() noexcept : SeqLock(T{})
+    {
+    }
+
+    explicit SeqLock(const T &value) noexcept
+    {
+        _store_words(value);
+    }
+
+    SeqLock(const SeqLock &) = delete;
+    SeqLock &operator=(const SeqLock &) = delete;
+
+    void store(const T &value) noexcept
+    {
+        const u64_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        _store_words(value);
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /// @brief Spins until it gets a copy no store() overlapped.
+    [[nodiscard]] T load() const noexcept
+    {
+        T value;
+        while (!try_load(value))
+            _mm_pause();
+        return value;
+    }
+
+    /// @brief One attempt at a consistent copy.
+    /// @return False if a store() was in progress or overlapped the copy;
+    /// `out` is unspecified then.
+    [[nodiscard]] bool try_load(T &out) const noexcept
+    {
+        const u64_t before = m_seq.load(std::memory_order_acquire);
+        if (before & 1)
+            return false;
+        u64_t words[WORDS];
+        for (sz_t i = 0; i < WORDS; ++i)
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_seq.load(std::memory_order_relaxed) != before)
+            return false;
+        std::memcpy(&out, words, sizeof(T));
+        return true;
+    }
+
+    /// @brief Number of completed stores. Lets a reader skip work when
+    /// nothing changed since it last looked.
+    [[nodiscard]] u64_t version() const noexcept
+    {
+        return m_seq.load(std::memory_order_acquire) / 2;
+    }
+
+  private:
+    static constexpr sz_t WORDS{(sizeof(T) + sizeof(u64_t) - 1) / sizeof(u64_t)};
+
+    // Sequence and payload share a line: a reader pulls in one line per copy
+    alignas(cacheline_t::value) std::atomic<u64_t> m_seq{0};
+    std::atomic<u64_t> m_words[WORDS];
+
+    void _store_words(const T &value) noexcept
+    {
+        u64_t words[WORDS]{};
+        std::memcpy(words, &value, sizeof(T));
+        for (sz_t i = 0; i < WORDS; ++i)
+            m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+};
+
+} // End namespace fiah
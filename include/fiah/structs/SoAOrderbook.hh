@@ -0,0 +1,506 @@
+#pragma once
+
+// C++ Includes
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <vector>
+
+// FastInAHurry Includes
+#include "fiah/structs/FlatIdMap.hh"
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Sorted-vector order book in structure-of-arrays layout.
+///
+/// Same shape as `Orderbook` (each side sorted with the best order at the
+/// back, FIFO within a price), but prices, quantities and ids sit in three
+/// parallel arrays. Deciding how far an aggressor sweeps only reads the price
+/// and quantity arrays: one fused kernel walks them from the back, eight
+/// orders per step (AVX2 when available), and stops at the first order that
+/// no longer crosses or once the running quantity covers the aggressor. Trades
+/// are then emitted for exactly that many orders and the filled tail is cut
+/// off all three arrays in one resize.
+///
+/// Cancels are O(1) amortised and never shift the arrays: the order stays
+/// put as a ghost (its id recorded in a side table) until matching reaches it
+/// or the side, once more than half ghosts, is compacted in one pass. Ghost
+/// quantity still counts in the sweep kernel, so a sweep that turns out
+/// short because of ghosts simply runs again on what is left, and FOK uses
+/// an exact scalar check while its side holds any.
+///
+/// Matching semantics, order types and trade layout are identical to
+/// `Orderbook`.
+class SoAOrderbook
+{
+  public:
+    static constexpr sz_t PREFETCH_DISTANCE{4};
+    /// The one id the index cannot hold; AddOrder() drops orders carrying it.
+    static constexpr Id RESERVED_ID{std::numeric_limits<Id>::max()}; // FlatIdMap::EMPTY_KEY
+
+    SoAOrderbook() = default;
+
+    bool is_dupe(const Order &order) const noexcept
+    {
+        return m_index.contains(order.get_id());
+    }
+
+    [[nodiscard]]
+    Trades AddOrder(const Order &incoming)
+    {
+        Trades trades;
+        AddOrder(incoming, [&trades](const Trade &trade) { trades.push_back(trade); });
+        return trades;
+    }
+
+    template <TradeSink Sink> void AddOrder(const Order &incoming, Sink &&sink)
+    {
+        if (incoming.get_id() == RESERVED_ID || is_dupe(incoming))
+            return;
+
+        Side &opposite = incoming.is_buy() ? m_asks : m_bids;
+        if (incoming.get_type() == Order::Type::FOK && !can_fill(incoming))
+            return;
+
+        Quantity remaining = incoming.get_qty();
+        for (;;)
+        {
+            const Extent extent = _sweep_extent(opposite, incoming, remaining);
+            const sz_t dead_before = opposite.dead;
+            remaining = _fill(opposite, incoming, extent.count, remaining, sink);
+            // Only ghosts in the extent can leave a "complete" sweep short
+            if (remaining == 0 || !extent.complete || opposite.dead == dead_before)
+                break;
+        }
+        if (remaining > 0 && incoming.rests())
+            _rest(incoming.get_id(), incoming.get_level(), incoming.is_buy(), remaining);
+    }
+
+    /// @brief Matches a batch in order; same results as one AddOrder each,
+    /// with the id-index slot of the order PREFETCH_DISTANCE places ahead
+    /// prefetched while the current one is matched.
+    template <TradeSink Sink> void AddOrders(std::span<const Order> orders, Sink &&sink)
+    {
+        const sz_t n = orders.size();
+        for (sz_t i = 0; i < std::min(n, PREFETCH_DISTANCE); ++i)
+            m_index.prefetch(orders[i].get_id());
+        for (sz_t i = 0; i < n; ++i)
+        {
+            if (i + PREFETCH_DISTANCE < n)
+                m_index.prefetch(orders[i + PREFETCH_DISTANCE].get_id());
+            AddOrder(orders[i], sink);
+        }
+    }
+
+    /// @return True if the opposite side holds enough crossing quantity to
+    /// fill `order` completely.
+    bool can_fill(const Order &order) const noexcept
+    {
+        const Side &opposite = order.is_buy() ? m_asks : m_bids;
+        if (opposite.dead == 0)
+            return _sweep_extent(opposite, order, order.get_qty()).complete;
+
+        Quantity needed = order.get_qty();
+        for (sz_t i = opposite.prices.size(); i-- > 0 && order.crosses(opposite.prices[i]);)
+        {
+            if (_is_dead(opposite, i))
+                continue;
+            if (opposite.qtys[i] >= needed)
+                return true;
+            needed -= opposite.qtys[i];
+        }
+        return false;
+    }
+
+    /// @brief Removes a resting order without touching the arrays beyond
+    /// trimming ghosts off the back. O(1) amortised; unknown ids are ignored.
+    void CancelOrder(Id order_id)
+    {
+        const Locator *loc = m_index.find(order_id);
+        if (!loc)
+            return;
+        const Locator gone = *loc;
+        m_index.erase(order_id);
+        m_ghosts.insert(order_id, gone);
+        _bury(gone.is_buy ? m_bids : m_asks);
+    }
+
+    [[nodiscard]]
+    Trades ModifyOrder(Id order_id, Quantity new_qty, Price new_price)
+    {
+        Trades trades;
+        ModifyOrder(order_id, new_qty, new_price, [&trades](const Trade &trade) { trades.push_back(trade); });
+        return trades;
+    }
+
+    /// @brief Same contract as Orderbook::ModifyOrder.
+    template <TradeSink Sink> void ModifyOrder(Id order_id, Quantity new_qty, Price new_price, Sink &&sink)
+    {
+        const Locator *loc = m_index.find(order_id);
+        if (!loc)
+            return;
+
+        const bool is_buy = loc->is_buy;
+        Side &side = is_buy ? m_bids : m_asks;
+        const sz_t pos = _position(side, order_id, loc->level, is_buy);
+        if (new_qty > 0 && new_price == side.prices[pos] && new_qty <= side.qtys[pos])
+        {
+            side.qtys[pos] = new_qty;
+            return;
+        }
+
+        // Marked in place; a zero quantity is invisible to the sweep kernel
+        side.qtys[pos] = 0;
+        m_index.erase(order_id);
+        _bury(side);
+        if (new_qty > 0)
+            AddOrder(Order{order_id, new_price, is_buy, new_qty}, sink);
+    }
+
+    sz_t size() const noexcept
+    {
+        return m_index.size();
+    }
+
+    bool has_bids() const noexcept
+    {
+        return !m_bids.prices.empty();
+    }
+
+    bool has_asks() const noexcept
+    {
+        return !m_asks.prices.empty();
+    }
+
+    /// @pre has_bids()
+    Price best_bid() const noexcept
+    {
+        return m_bids.prices.back();
+    }
+
+    /// @pre has_asks()
+    Price best_ask() const noexcept
+    {
+        return m_asks.prices.back();
+    }
+
+    /// @brief Copies up to `out.size()` best levels of one side, best first.
+    /// Costs O(orders on those levels).
+    /// @return Number of levels written.
+    sz_t top_levels(Order::Side side, std::span<DepthLevel> out) const noexcept
+    {
+        const Side &book_side = side == Order::Side::BUY ? m_bids : m_asks;
+        sz_t n = 0;
+        for (sz_t i = book_side.prices.size(); i-- > 0;)
+        {
+            if (_is_dead(book_side, i))
+                continue;
+            if (n > 0 && out[n - 1].price == book_side.prices[i])
+            {
+                out[n - 1].qty += book_side.qtys[i];
+                ++out[n - 1].count;
+                continue;
+            }
+            if (n == out.size())
+                break;
+            out[n++] = DepthLevel{book_side.prices[i], book_side.qtys[i], 1};
+        }
+        return n;
+    }
+
+  private:
+    struct Locator
+    {
+        Price level;
+        bool is_buy;
+    };
+
+    /// One side of the book. Bids ascend and asks descend by price, so the
+    /// best order is always at the back; within a price, older orders sit
+    /// closer to the back. The back order is never a tombstone.
+    struct Side
+    {
+        std::vector<Price> prices;
+        std::vector<Quantity> qtys;
+        std::vector<Id> ids;
+        sz_t dead{0}; ///< Tombstones: zero qty, or an id in m_ghosts
+
+        void insert(sz_t pos, Price price, Quantity qty, Id id)
+        {
+            const auto at = static_cast<std::ptrdiff_t>(pos);
+            prices.insert(prices.begin() + at, price);
+            qtys.insert(qtys.begin() + at, qty);
+            ids.insert(ids.begin() + at, id);
+        }
+
+        void truncate(sz_t n) noexcept
+        {
+            prices.resize(n);
+            qtys.resize(n);
+            ids.resize(n);
+        }
+    };
+
+    /// How many orders, counted from the back, an aggressor trades with, and
+    /// whether they cover its whole quantity.
+    struct Extent
+    {
+        sz_t count;
+        bool complete;
+    };
+
+    static constexpr sz_t BLOCK{8};
+
+    Side m_bids{};
+    Side m_asks{};
+    FlatIdMap<Id, Locator> m_index{};
+    // Cancelled orders still in a side; never shares an id with a live order
+    FlatIdMap<Id, Locator> m_ghosts{};
+
+    /// Distance, in orders, at which _fill() prefetches the id-index slot of
+    /// an order it is about to erase.
+    static constexpr sz_t INDEX_PREFETCH_DISTANCE{8};
+
+    /// @brief Trades `remaining` against the back `count` orders of
+    /// `opposite`. The extent kernel guarantees every one of them but the
+    /// last is filled outright, so only the last needs a min() and a survival
+    /// check. Tombstones in the extent are dropped without trading.
+    template <class Sink>
+    Quantity _fill(Side &opposite, const Order &incoming, sz_t count, Quantity remaining, Sink &sink)
+    {
+        if (count == 0)
+            return remaining;
+
+        const sz_t n = opposite.prices.size();
+        const Price *prices = opposite.prices.data();
+        Quantity *qtys = opposite.qtys.data();
+        const Id *ids = opposite.ids.data();
+
+        // Same conventions as Orderbook: price comes from the ask side (the
+        // bid's for a market sell), bid order id first
+        const bool is_buy = incoming.is_buy();
+        const bool own_price = !is_buy && !incoming.is_market();
+        auto emit = [&](sz_t idx, Quantity size) {
+            const Price price = own_price ? incoming.get_level() : prices[idx];
+            sink(is_buy ? Trade{incoming.get_id(), ids[idx], incoming.get_id(), true, price, size}
+                        : Trade{ids[idx], incoming.get_id(), incoming.get_id(), false, price, size});
+        };
+
+        for (sz_t j = 0; j < std::min(count, INDEX_PREFETCH_DISTANCE); ++j)
+            m_index.prefetch(ids[n - 1 - j]);
+
+        // Everything from `last` up is cut off below, tombstones included
+        auto drop_dead = [&](sz_t idx) {
+            if (qtys[idx] != 0 && (opposite.dead == 0 || !m_ghosts.erase(ids[idx])))
+                return false;
+            --opposite.dead;
+            return true;
+        };
+
+        const sz_t last = n - count;
+        for (sz_t idx = n - 1; idx > last; --idx)
+        {
+            if (idx >= last + INDEX_PREFETCH_DISTANCE)
+                m_index.prefetch(ids[idx - INDEX_PREFETCH_DISTANCE]);
+            if (drop_dead(idx)) [[unlikely]]
+                continue;
+            emit(idx, qtys[idx]);
+            remaining -= qtys[idx];
+            m_index.erase(ids[idx]);
+        }
+
+        if (drop_dead(last)) [[unlikely]]
+            opposite.truncate(last);
+        else
+        {
+            const Quantity trade_size = std::min(qtys[last], remaining);
+            emit(last, trade_size);
+            remaining -= trade_size;
+            qtys[last] -= trade_size;
+            if (qtys[last] == 0)
+            {
+                m_index.erase(ids[last]);
+                opposite.truncate(last);
+            }
+            else
+                opposite.truncate(last + 1);
+        }
+        _trim(opposite);
+        return remaining;
+    }
+
+    bool _is_dead(const Side &side, sz_t i) const noexcept
+    {
+        return side.qtys[i] == 0 || (side.dead != 0 && m_ghosts.contains(side.ids[i]));
+    }
+
+    /// Pops tombstones off the back so best_bid()/best_ask() stay live.
+    void _trim(Side &side) noexcept
+    {
+        while (!side.prices.empty() && _is_dead(side, side.prices.size() - 1))
+        {
+            if (side.qtys.back() != 0)
+                m_ghosts.erase(side.ids.back());
+            side.truncate(side.prices.size() - 1);
+            --side.dead;
+        }
+    }
+
+    /// Counts a new tombstone and compacts the side once tombstones
+    /// outnumber live orders there, so each pass is paid for by the cancels
+    /// that made it necessary.
+    void _bury(Side &side) noexcept
+    {
+        ++side.dead;
+        _trim(side);
+        if (side.dead * 2 > side.prices.size())
+            _compact(side);
+    }
+
+    /// Drops every tombstone from one side in a single stable pass.
+    void _compact(Side &side) noexcept
+    {
+        sz_t kept = 0;
+        for (sz_t i = 0; i < side.prices.size(); ++i)
+        {
+            if (side.qtys[i] == 0 || m_ghosts.erase(side.ids[i]))
+                continue;
+            side.prices[kept] = side.prices[i];
+            side.qtys[kept] = side.qtys[i];
+            side.ids[kept] = side.ids[i];
+            ++kept;
+        }
+        side.truncate(kept);
+        side.dead = 0;
+    }
+
+    /// An id is being reused while its cancelled order is still in a side:
+    /// mark that ghost in place (one level scan, rare) so the id stops
+    /// meaning "dead".
+    void _mark_ghost(Id id) noexcept
+    {
+        const Locator *ghost = m_ghosts.find(id);
+        if (!ghost)
+            return;
+        Side &side = ghost->is_buy ? m_bids : m_asks;
+        side.qtys[_position(side, id, ghost->level, ghost->is_buy)] = 0;
+        m_ghosts.erase(id);
+    }
+
+    void _rest(Id id, Price price, bool is_buy, Quantity qty)
+    {
+        if (!m_ghosts.empty()) [[unlikely]]
+            _mark_ghost(id);
+        m_index.insert(id, Locator{price, is_buy});
+        Side &side = is_buy ? m_bids : m_asks;
+        auto pos = is_buy ? std::ranges::lower_bound(side.prices, price, std::less<Price>())
+                          : std::ranges::lower_bound(side.prices, price, std::greater<Price>());
+        side.insert(static_cast<sz_t>(pos - side.prices.begin()), price, qty, id);
+    }
+
+    static sz_t _position(const Side &side, Id id, Price price, bool is_buy) noexcept
+    {
+        auto run = is_buy ? std::ranges::equal_range(side.prices, price, std::less<Price>())
+                          : std::ranges::equal_range(side.prices, price, std::greater<Price>());
+        const auto first = static_cast<sz_t>(run.begin() - side.prices.begin());
+        const auto last = static_cast<sz_t>(run.end() - side.prices.begin());
+        sz_t pos = first;
+        while (pos < last && (side.ids[pos] != id || side.qtys[pos] == 0))
+            ++pos;
+        return pos;
+    }
+
+    /// @brief Fused crossing + cumulative-quantity scan from the back of
+    /// `opposite`. Touches only the price and quantity arrays.
+    static Extent _sweep_extent(const Side &opposite, const Order &incoming, Quantity want) noexcept
+    {
+        if (want <= 0) [[unlikely]]
+            return {0, true};
+
+        const Price *prices = opposite.prices.data();
+        const Quantity *qtys = opposite.qtys.data();
+        sz_t i = opposite.prices.size(); // orders [0, i) not yet scanned
+        Quantity cum = 0;
+
+        // Most aggressors are covered by the order at the touch
+        if (i > 0 && qtys[i - 1] >= want && incoming.crosses(prices[i - 1]))
+            return {1, true};
+
+#if defined(__AVX2__)
+        // Lanes are loaded front-to-back; scan order is back-to-front, so the
+        // quantity block is reversed before the prefix sum.
+        const __m256i limit = _mm256_set1_epi64x(incoming.get_level());
+        const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+        const bool is_buy = incoming.is_buy();
+        const bool is_market = incoming.is_market();
+        while (i >= BLOCK)
+        {
+            const sz_t base = i - BLOCK;
+
+            // Bit j set: order base+j does not cross
+            u32_t stop_bits = 0;
+            if (!is_market)
+            {
+                const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(prices + base));
+                const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(prices + base + 4));
+                const __m256i stop_lo = is_buy ? _mm256_cmpgt_epi64(lo, limit) : _mm256_cmpgt_epi64(limit, lo);
+                const __m256i stop_hi = is_buy ? _mm256_cmpgt_epi64(hi, limit) : _mm256_cmpgt_epi64(limit, hi);
+                stop_bits = static_cast<u32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(stop_lo))) |
+                            static_cast<u32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(stop_hi))) << 4;
+            }
+            // Sorted side: crossing orders are a suffix of the block
+            const sz_t crossing = stop_bits ? static_cast<sz_t>(std::countl_zero(stop_bits << 24)) : BLOCK;
+
+            // Inclusive prefix sum of quantities, back of the block first
+            __m256i q = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(qtys + base));
+            q = _mm256_permutevar8x32_epi32(q, reverse);
+            q = _mm256_add_epi32(q, _mm256_slli_si256(q, 4));
+            q = _mm256_add_epi32(q, _mm256_slli_si256(q, 8));
+            const __m256i low_total = _mm256_shuffle_epi32(_mm256_permute2x128_si256(q, q, 0x08), 0xFF);
+            q = _mm256_add_epi32(q, low_total);
+            q = _mm256_add_epi32(q, _mm256_set1_epi32(cum));
+
+            // Bit j set: the back j+1 orders cover the aggressor
+            const __m256i enough = _mm256_cmpgt_epi32(q, _mm256_set1_epi32(want - 1));
+            const auto enough_bits = static_cast<u32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(enough)));
+            if (enough_bits)
+            {
+                const auto needed = static_cast<sz_t>(std::countr_zero(enough_bits)) + 1;
+                if (needed <= crossing)
+                    return {opposite.prices.size() - base - BLOCK + needed, true};
+            }
+            if (crossing < BLOCK)
+                return {opposite.prices.size() - base - BLOCK + crossing, false};
+
+            cum = _mm256_extract_epi32(q, 7);
+            i = base;
+        }
+#endif
+
+        for (; i > 0; --i)
+        {
+            if (!incoming.crosses(prices[i - 1]))
+                break;
+            // want - cum is positive here, so this cannot overflow
+            if (qtys[i - 1] >= want - cum)
+                return {opposite.prices.size() - i + 1, true};
+            cum += qtys[i - 1];
+        }
+        return {opposite.prices.size() - i, false};
+    }
+};
+
+static_assert(OrderbookLike<SoAOrderbook>);
+
+} // End namespace fiah
@@ -0,0 +1,29 @@
+#pragma once
+
+// C++ Includes
+#include <pthread.h>
+#include <sched.h>
+
+#include <thread>
+
+namespace fiah
+{
+
+/// @brief Pins a thread to a single logical core.
+/// @return False if the core is out of range or the kernel refused the mask.
+inline bool pin_to_core(std::thread::native_handle_type handle, int core) noexcept
+{
+    if (core < 0 || core >= CPU_SETSIZE)
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return ::pthread_setaffinity_np(handle, sizeof(set), &set) == 0;
+}
+
+inline bool pin_this_thread(int core) noexcept
+{
+    return pin_to_core(::pthread_self(), core);
+}
+
+} // namespace fiah
@@ -0,0 +1,246 @@
+#pragma once
+
+// C++ Includes
+#include <x86intrin.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <iomanip>
+#include <ostream>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// FastInAHurry Includes
+#include "fiah/utils/Types.hh"
+
+namespace fiah
+{
+
+/// @brief Log-linear histogram of cycle counts: each power of two is split
+/// into SUB_BUCKETS linear buckets, so any reported percentile is within 25%
+/// of the true value across the whole u64 range, in 2 KiB.
+///
+/// Counters are relaxed atomics bumped with a plain load and store, not a
+/// locked add: there is one writer, and readers on other threads only need
+/// untorn values, not a consistent cut across buckets.
+///
+/// @attention record() and reset() must only ever be called from one thread.
+class LatencyHistogram
+{
+  public:
+    static constexpr u32_t SUB_BITS{2};
+    static constexpr u32_t SUB_BUCKETS{1U << SUB_BITS};
+    static constexpr sz_t NUM_BUCKETS{(64 - SUB_BITS + 1) * SUB_BUCKETS};
+
+    LatencyHistogram() noexcept = default;
+
+    LatencyHistogram(const LatencyHistogram &other) noexcept
+    {
+        for (sz_t i = 0; i < NUM_BUCKETS; ++i)
+            _set(m_buckets[i], other.m_buckets[i].load(std::memory_order_relaxed));
+        _set(m_count, other.count());
+        _set(m_sum, other.sum());
+        _set(m_max, other.max());
+    }
+
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    [[gnu::always_inline]] void record(u64_t value) noexcept
+    {
+        _bump(m_buckets[bucket_of(value)], 1);
+        _bump(m_count, 1);
+        _bump(m_sum, value);
+        if (value > m_max.load(std::memory_order_relaxed))
+            _set(m_max, value);
+    }
+
+    void reset() noexcept
+    {
+        for (auto &bucket : m_buckets)
+            _set(bucket, 0);
+        _set(m_count, 0);
+        _set(m_sum, 0);
+        _set(m_max, 0);
+    }
+
+    u64_t count() const noexcept
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    u64_t sum() const noexcept
+    {
+        return m_sum.load(std::memory_order_relaxed);
+    }
+
+    u64_t max() const noexcept
+    {
+        return m_max.load(std::memory_order_relaxed);
+    }
+
+    /// @return Upper bound of the bucket holding the `q` quantile (0..1),
+    /// capped at max(). Zero if nothing was recorded.
+    u64_t percentile(double q) const noexcept
+    {
+        const u64_t total = count();
+        if (total == 0)
+            return 0;
+        const auto rank = static_cast<u64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(total - 1)) + 1;
+        u64_t seen = 0;
+        for (sz_t i = 0; i < NUM_BUCKETS; ++i)
+        {
+            seen += m_buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+                return std::min(bucket_upper(i), max());
+        }
+        return max();
+    }
+
+    /// Values below SUB_BUCKETS get a bucket each; above that, the top
+    /// SUB_BITS bits under the most significant one pick the sub-bucket.
+    static constexpr sz_t bucket_of(u64_t value) noexcept
+    {
+        if (value < SUB_BUCKETS)
+            return static_cast<sz_t>(value);
+        const auto msb = static_cast<u32_t>(std::bit_width(value)) - 1;
+        const auto sub = static_cast<sz_t>((value >> (msb - SUB_BITS)) & (SUB_BUCKETS - 1));
+        return (msb - SUB_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    /// @return Largest value that lands in `bucket`.
+    static constexpr u64_t bucket_upper(sz_t bucket) noexcept
+    {
+        if (bucket < SUB_BUCKETS)
+            return bucket;
+        const auto group = static_cast<u32_t>(bucket / SUB_BUCKETS);
+        const u64_t lower = (SUB_BUCKETS + bucket % SUB_BUCKETS) << (group - 1);
+        return lower + ((u64_t{1} << (group - 1)) - 1);
+    }
+
+  private:
+    static void _bump(std::atomic<u64_t> &counter, u64_t by) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    static void _set(std::atomic<u64_t> &counter, u64_t value) noexcept
+    {
+        counter.store(value, std::memory_order_relaxed);
+    }
+
+    std::atomic<u64_t> m_buckets[NUM_BUCKETS]{};
+    std::atomic<u64_t> m_count{0};
+    std::atomic<u64_t> m_sum{0};
+    std::atomic<u64_t> m_max{0};
+};
+
+/// @brief Phase enums a TscProbe can index: dense from zero, closed by COUNT.
+template <class Phase>
+concept ProbePhase = std::is_enum_v<Phase> && requires { Phase::COUNT; };
+
+/// @brief Default probe: every call is an empty constexpr function and the
+/// member holding it takes no space, so instrumented code compiles to exactly
+/// what it was without the probe.
+struct NoProbe
+{
+    struct Stamp
+    {
+    };
+
+    static constexpr Stamp start() noexcept
+    {
+        return {};
+    }
+
+    template <class Phase> static constexpr Stamp lap(Phase, Stamp) noexcept
+    {
+        return {};
+    }
+};
+
+/// @brief Per-phase TSC histograms. Instrumented code calls start() once and
+/// then lap(phase, stamp) at each phase boundary; each lap is one rdtsc and a
+/// handful of relaxed counter stores. Cycle deltas are recorded raw; scale
+/// them with calibrate_tsc() when dumping.
+///
+/// Phase names come from a `phase_name(Phase)` found by argument-dependent
+/// lookup, next to the enum.
+template <ProbePhase Phase> class TscProbe
+{
+  public:
+    using Stamp = u64_t;
+    static constexpr sz_t NUM_PHASES{static_cast<sz_t>(std::to_underlying(Phase::COUNT))};
+
+    [[gnu::always_inline]] static Stamp start() noexcept
+    {
+        return __rdtsc();
+    }
+
+    /// @brief Records the cycles since `since` under `phase`.
+    /// @return The new stamp, to pass to the next lap.
+    [[gnu::always_inline]] Stamp lap(Phase phase, Stamp since) noexcept
+    {
+        const u64_t now = __rdtsc();
+        m_phases[static_cast<sz_t>(std::to_underlying(phase))].record(now - since);
+        return now;
+    }
+
+    const LatencyHistogram &histogram(Phase phase) const noexcept
+    {
+        return m_phases[static_cast<sz_t>(std::to_underlying(phase))];
+    }
+
+    void reset() noexcept
+    {
+        for (auto &phase : m_phases)
+            phase.reset();
+    }
+
+    /// @brief One line per phase: count, mean and percentiles, in nanoseconds
+    /// if `ns_per_cycle` is given, else in cycles. Safe to call from another
+    /// thread while the book is running.
+    void dump(std::ostream &os, double ns_per_cycle = 0.0) const
+    {
+        const double scale = ns_per_cycle > 0.0 ? ns_per_cycle : 1.0;
+        auto scaled = [scale](double value) { return value * scale; };
+        os << std::left << std::setw(14) << "phase" << std::right << std::setw(12) << "count" << std::setw(10)
+           << "mean" << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(12)
+           << "max" << (ns_per_cycle > 0.0 ? "  (ns)\n" : "  (cycles)\n");
+        os << std::fixed << std::setprecision(1);
+        for (sz_t i = 0; i < NUM_PHASES; ++i)
+        {
+            const LatencyHistogram &h = m_phases[i];
+            const u64_t n = h.count();
+            const double mean = n ? static_cast<double>(h.sum()) / static_cast<double>(n) : 0.0;
+            os << std::left << std::setw(14) << phase_name(static_cast<Phase>(i)) << std::right << std::setw(12) << n
+               << std::setw(10) << scaled(mean) << std::setw(10) << scaled(static_cast<double>(h.percentile(0.50)))
+               << std::setw(10) << scaled(static_cast<double>(h.percentile(0.99))) << std::setw(10)
+               << scaled(static_cast<double>(h.percentile(0.999))) << std::setw(12)
+               << scaled(static_cast<double>(h.max())) << '\n';
+        }
+        os << std::defaultfloat;
+    }
+
+  private:
+    LatencyHistogram m_phases[NUM_PHASES];
+};
+
+/// @brief Measures the TSC against the steady clock over `window`.
+/// @return Nanoseconds per TSC cycle.
+inline double calibrate_tsc(std::chrono::microseconds window = std::chrono::milliseconds{10})
+{
+    using Clock = std::chrono::steady_clock;
+    const auto wall_start = Clock::now();
+    const u64_t tsc_start = __rdtsc();
+    std::this_thread::sleep_for(window);
+    const u64_t cycles = __rdtsc() - tsc_start;
+    const auto ns = std::chrono::nanoseconds{Clock::now() - wall_start}.count();
+    return cycles ? static_cast<double>(ns) / static_cast<double>(cycles) : 0.0;
+}
+
+} // End namespace fiah
@@ -99,7 +99,7 @@ private:
 
     void _run(std::stop_token st) noexcept;
 
-    void _flush(Record* recs, u32_t n) noexcept;
+    void _write(const Record& rec) noexcept;
 
     i32_t _serialize(char* out, const Record& rec, u32_t n) const noexcept;
 
@@ -132,24 +132,21 @@ SPSCLogger::~SPSCLogger() noexcept
 
 void SPSCLogger::_run(std::stop_token st) noexcept
 {
-    constexpr u32_t OUT_LIST_SIZE{10};
-    Record out_list[OUT_LIST_SIZE]; // buffering records before flushing
-    u32_t list_tracker{};
-
     Vector<QueueT*> q_snapshot;
     q_snapshot.reserve(EXPECTED_NUM_PRODUCERS);
     auto drain = [&]() {
         for (QueueT* q : q_snapshot)
         {
-            Record rec{};
-            while(q->pop(rec))
+            // Serialize straight out of the ring slot, no copy of the Record
+            u32_t written{};
+            while(const Record* rec = q->front())
             {
-                out_list[list_tracker++] = rec;
-                if (list_tracker >= OUT_LIST_SIZE)
-                    _flush(out_list, list_tracker), list_tracker = 0;
+                _write(*rec);
+                q->release();
+                ++written;
             }
-            if (list_tracker > 0U)
-                _flush(out_list, list_tracker), list_tracker = 0;
+            if (written > 0U)
+                std::fflush(stdout);
         }
     };
 
@@ -205,17 +202,11 @@ i32_t SPSCLogger::_serialize(char* out, const Record& rec, u32_t len) const noex
     );
 }
 
-void SPSCLogger::_flush(Record* recs, u32_t n) noexcept
+void SPSCLogger::_write(const Record& rec) noexcept
 {
     char line[Record::BUFF_SIZE + 512];
-    for (u32_t i{}; i < n; ++i)
-    {
-        Record& rec = recs[i];
-        int written_bytes = _serialize(line, rec, sizeof(line));
-        std::fwrite(line, 1, written_bytes < 0 ? 0uz : static_cast<std::size_t>(written_bytes), stdout);
-    }
-    std::fflush(stdout);
-
+    int written_bytes = _serialize(line, rec, sizeof(line));
+    std::fwrite(line, 1, written_bytes < 0 ? 0uz : static_cast<std::size_t>(written_bytes), stdout);
 }
 
 auto SPSCLogger::_register_thread() noexcept -> QueueT* 
@@ -271,7 +262,12 @@ template <class... Args>
 __always_inline
 void SPSCLogger::_log(SPSCLogger::Level level, Location loc, const char* fmt, Args&&... args) noexcept
 {
-    Record rec;
+    // Format straight into the ring slot; a full queue drops the record
+    QueueT* q = _get_queue_ptr();
+    Record* slot = q->try_reserve();
+    if (!slot) [[unlikely]]
+        return;
+    Record& rec = *slot;
     rec.ts_ns = static_cast<u64_t>(TimeStamp<Resolution::Nano, std::chrono::system_clock>{}.get_ticks());
     rec.loc   = loc;
     rec.buff_size = 0;
@@ -284,7 +280,7 @@ void SPSCLogger::_log(SPSCLogger::Level level, Location loc, const char* fmt, Ar
 
     rec.buff_size = std::min(static_cast<u16_t>(n), static_cast<u16_t>(Record::BUFF_SIZE - 1)); // snprintf writes a null terminator
 
-    _get_queue_ptr()->push(rec);
+    q->commit();
 }
 
 /*static*/ const char* SPSCLogger::_level_to_string(SPSCLogger::Level level) noexcept
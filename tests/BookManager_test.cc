@@ -0,0 +1,102 @@
+// clang-format off
+#include "fiah/engine/BookManager.hh"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/utils/XorBitant.hh"
+// clang-format on
+
+using namespace fiah;
+
+class BookManagerTest : public ::testing::Test
+{
+  protected:
+    static constexpr sz_t NUM_SYMBOLS{37};
+
+    static LadderOrderbook make_book()
+    {
+        return LadderOrderbook{256, 1024};
+    }
+
+    /// Random add/cancel/modify flow over all symbols, ids unique per symbol
+    static std::vector<OrderEvent> make_flow(sz_t n)
+    {
+        std::vector<OrderEvent> events;
+        std::vector<Id> next_id(NUM_SYMBOLS, 1);
+        XorBitant rng{7};
+        for (sz_t i = 0; i < n; ++i)
+        {
+            const auto symbol = static_cast<SymbolId>(rng() % NUM_SYMBOLS);
+            Id &id = next_id[symbol];
+            const auto action = rng() % 6;
+            const Price price = 100 + static_cast<Price>(rng() % 16);
+            const Quantity qty = 1 + static_cast<Quantity>(rng() % 9);
+            if (id > 1 && action == 0)
+                events.push_back(OrderEvent::cancel(symbol, 1 + rng() % (id - 1)));
+            else if (id > 1 && action == 1)
+                events.push_back(OrderEvent::modify(symbol, 1 + rng() % (id - 1), qty, price));
+            else
+                events.push_back(OrderEvent::add(symbol, Order{id++, price, (rng() & 1) != 0, qty}));
+        }
+        return events;
+    }
+};
+
+TEST_F(BookManagerTest, RejectsUnknownSymbol)
+{
+    BookManager<> manager{4, 2, &make_book};
+    EXPECT_FALSE(manager.submit(OrderEvent::cancel(4, 1)));
+    EXPECT_TRUE(manager.submit(OrderEvent::cancel(3, 1)));
+    manager.drain();
+}
+
+TEST_F(BookManagerTest, ShardedMatchesSingleThreaded)
+{
+    const auto events = make_flow(50000);
+
+    // Reference: every book applied in order on this thread
+    std::vector<LadderOrderbook> reference;
+    for (sz_t s = 0; s < NUM_SYMBOLS; ++s)
+        reference.push_back(make_book());
+    std::vector<u64_t> expected_trades(NUM_SYMBOLS, 0);
+    for (const auto &event : events)
+        apply_event(reference[event.symbol], event, [&](const Trade &) { ++expected_trades[event.symbol]; });
+
+    struct PerSymbolCounter
+    {
+        std::vector<u64_t> trades = std::vector<u64_t>(NUM_SYMBOLS, 0);
+        void operator()(SymbolId symbol, const Trade &) noexcept
+        {
+            ++trades[symbol];
+        }
+    };
+
+    BookManager<LadderOrderbook, PerSymbolCounter, 256> manager{NUM_SYMBOLS, 3, &make_book};
+    for (const auto &event : events)
+    {
+        while (!manager.submit(event))
+            ;
+    }
+    manager.drain();
+
+    std::vector<u64_t> actual_trades(NUM_SYMBOLS, 0);
+    for (sz_t shard = 0; shard < manager.num_shards(); ++shard)
+    {
+        for (sz_t s = 0; s < NUM_SYMBOLS; ++s)
+            actual_trades[s] += manager.trade_handler(shard).trades[s];
+    }
+    EXPECT_EQ(actual_trades, expected_trades);
+
+    for (SymbolId s = 0; s < NUM_SYMBOLS; ++s)
+    {
+        EXPECT_EQ(manager.book(s).size(), reference[s].size()) << "symbol " << s;
+        EXPECT_EQ(manager.book(s).has_bids(), reference[s].has_bids());
+        if (reference[s].has_bids())
+        {
+            EXPECT_EQ(manager.book(s).best_bid(), reference[s].best_bid());
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "fiah/engine/ConflatedDepth.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/utils/XorBitant.hh"
+
+using namespace fiah;
+
+namespace
+{
+struct Delivered
+{
+    OrderSide side;
+    sz_t level;
+    DepthLevel value;
+};
+
+template <sz_t LEVELS> std::vector<Delivered> drain_all(ConflatedDepth<LEVELS> &depth)
+{
+    std::vector<Delivered> out;
+    depth.drain([&out](OrderSide side, sz_t level, const DepthLevel &value) { out.push_back({side, level, value}); });
+    return out;
+}
+} // namespace
+
+TEST(ConflatedDepthTest, BurstIsConflatedToLatestPerLevel)
+{
+    Orderbook book;
+    ConflatedDepth<4> depth;
+    EXPECT_FALSE(depth.dirty());
+
+    // A burst of 100 adds at one price: one dirty level, one delivery
+    for (Id id = 1; id <= 100; ++id)
+    {
+        (void)book.AddOrder(Order{id, 100, true, 1});
+        depth.publish(book);
+    }
+    const auto first = drain_all(depth);
+    ASSERT_EQ(first.size(), 1);
+    EXPECT_EQ(first[0].side, OrderSide::BUY);
+    EXPECT_EQ(first[0].level, 0);
+    EXPECT_EQ(first[0].value.qty, 100);
+    EXPECT_EQ(first[0].value.count, 100);
+    EXPECT_TRUE(drain_all(depth).empty());
+
+    // Publishing an unchanged book marks nothing
+    EXPECT_EQ(depth.publish(book), 0);
+    EXPECT_FALSE(depth.dirty());
+}
+
+TEST(ConflatedDepthTest, VanishedLevelsArePublishedEmpty)
+{
+    Orderbook book;
+    ConflatedDepth<4> depth;
+    (void)book.AddOrder(Order{1, 101, false, 5});
+    (void)book.AddOrder(Order{2, 102, false, 5});
+    EXPECT_EQ(depth.publish(book), 2);
+    (void)drain_all(depth);
+
+    // Taking out the best ask shifts 102 into slot 0 and empties slot 1
+    (void)book.AddOrder(Order{3, 101, true, 5});
+    EXPECT_EQ(depth.publish(book), 2);
+    const auto out = drain_all(depth);
+    ASSERT_EQ(out.size(), 2);
+    EXPECT_EQ(out[0].value.price, 102);
+    EXPECT_EQ(out[1].level, 1);
+    EXPECT_EQ(out[1].value.qty, 0);
+    EXPECT_EQ(depth.level(OrderSide::SELL, 0).price, 102);
+}
+
+TEST(ConflatedDepthTest, DirectUpdateMarksOneLevel)
+{
+    ConflatedDepth<64> depth;
+    EXPECT_TRUE(depth.update(OrderSide::SELL, 63, DepthLevel{200, 3, 1}));
+    EXPECT_FALSE(depth.update(OrderSide::SELL, 63, DepthLevel{200, 3, 1}));
+    const auto out = drain_all(depth);
+    ASSERT_EQ(out.size(), 1);
+    EXPECT_EQ(out[0].level, 63);
+    EXPECT_EQ(out[0].value.price, 200);
+}
+
+// The publisher may drain at any point; once the writer stops, one last
+// drain must leave it holding exactly the book's final depth
+TEST(ConflatedDepthTest, ConcurrentDrainEndsOnFinalState)
+{
+    constexpr sz_t LEVELS{8};
+    LadderOrderbook book{1 << 10, 1 << 14};
+    ConflatedDepth<LEVELS> depth;
+    std::array<std::array<DepthLevel, LEVELS>, 2> seen{};
+    std::atomic<bool> done{false};
+
+    std::jthread publisher{[&] {
+        auto record = [&seen](OrderSide side, sz_t level, const DepthLevel &value) {
+            seen[side == OrderSide::BUY ? 0 : 1][level] = value;
+        };
+        while (!done.load(std::memory_order_acquire))
+            depth.drain(record);
+        depth.drain(record);
+    }};
+
+    fiah::XorBitant rng{5};
+    for (Id id = 1; id <= 20000; ++id)
+    {
+        if (id > 10 && rng() % 3 == 0)
+            book.CancelOrder(id - 1 - rng() % 10);
+        else
+            (void)book.AddOrder(Order{id, 1000 + static_cast<Price>(rng() % 32), (rng() & 1) != 0, 1});
+        depth.publish(book);
+    }
+    done.store(true, std::memory_order_release);
+    publisher.join();
+
+    for (OrderSide side : {OrderSide::BUY, OrderSide::SELL})
+    {
+        std::array<DepthLevel, LEVELS> expected{};
+        book.top_levels(side, expected);
+        for (sz_t i = 0; i < LEVELS; ++i)
+        {
+            const DepthLevel &got = seen[side == OrderSide::BUY ? 0 : 1][i];
+            EXPECT_EQ(got.price, expected[i].price) << i;
+            EXPECT_EQ(got.qty, expected[i].qty) << i;
+            EXPECT_EQ(got.count, expected[i].count) << i;
+        }
+    }
+}
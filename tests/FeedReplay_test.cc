@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "fiah/engine/FeedReplay.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/Orderbook.hh"
+
+using namespace fiah;
+
+namespace
+{
+std::string temp_feed_path(const char *name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+} // namespace
+
+TEST(FeedReplayTest, SyntheticFeedIsDeterministic)
+{
+    SyntheticFeedConfig config{.num_events = 5'000, .num_symbols = 3};
+    const auto a = make_synthetic_feed(config);
+    const auto b = make_synthetic_feed(config);
+    ASSERT_EQ(a.size(), config.num_events);
+    ASSERT_EQ(a.size(), b.size());
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        EXPECT_EQ(a[i].timestamp_ns, b[i].timestamp_ns);
+        EXPECT_EQ(a[i].event.id, b[i].event.id);
+        EXPECT_EQ(a[i].event.price, b[i].event.price);
+        EXPECT_LT(a[i].event.symbol, config.num_symbols);
+    }
+    for (std::size_t i = 1; i < a.size(); ++i)
+        EXPECT_LE(a[i - 1].timestamp_ns, a[i].timestamp_ns);
+}
+
+TEST(FeedReplayTest, WriteThenMapRoundTrips)
+{
+    const std::string path = temp_feed_path("fiah_feed_roundtrip.bin");
+    const auto records = make_synthetic_feed({.num_events = 1'000});
+    ASSERT_TRUE(write_feed(path, records));
+
+    auto feed = FeedReader::open(path);
+    ASSERT_TRUE(feed);
+    const auto mapped = feed->records();
+    ASSERT_EQ(mapped.size(), records.size());
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        EXPECT_EQ(mapped[i].timestamp_ns, records[i].timestamp_ns);
+        EXPECT_EQ(mapped[i].event.id, records[i].event.id);
+        EXPECT_EQ(mapped[i].event.type, records[i].event.type);
+        EXPECT_EQ(mapped[i].event.qty, records[i].event.qty);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(FeedReplayTest, RejectsForeignAndTruncatedFiles)
+{
+    EXPECT_EQ(FeedReader::open(temp_feed_path("fiah_feed_missing.bin")).error(), FileError::OPEN_FAIL);
+
+    const std::string path = temp_feed_path("fiah_feed_bad.bin");
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    const FeedHeader header{.count = 10}; // claims 10 records, carries none
+    std::fwrite(&header, sizeof(header), 1, f);
+    std::fclose(f);
+    EXPECT_EQ(FeedReader::open(path).error(), FileError::TRUNCATED);
+
+    f = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::fputs("definitely not a feed file, just some text", f);
+    std::fclose(f);
+    EXPECT_EQ(FeedReader::open(path).error(), FileError::BAD_HEADER);
+    std::remove(path.c_str());
+}
+
+TEST(FeedReplayTest, RejectsCorruptedRecords)
+{
+    const std::string path = temp_feed_path("fiah_feed_corrupt.bin");
+    auto records = make_synthetic_feed({.num_events = 100, .num_symbols = 2});
+
+    ASSERT_TRUE(write_feed(path, records));
+    auto feed = FeedReader::open(path);
+    ASSERT_TRUE(feed);
+    EXPECT_EQ(feed->num_symbols(), 2u);
+    EXPECT_EQ(FeedReader::open(path, true, 1).error(), FileError::BAD_RECORD);
+
+    // Raw byte pokes: a bad type, then a side byte that is not a valid bool
+    for (const std::size_t field : {offsetof(OrderEvent, type), offsetof(OrderEvent, is_buy)})
+    {
+        ASSERT_TRUE(write_feed(path, records));
+        std::FILE *f = std::fopen(path.c_str(), "r+b");
+        ASSERT_NE(f, nullptr);
+        const std::size_t at = sizeof(FeedHeader) + 50 * sizeof(FeedRecord) + offsetof(FeedRecord, event) + field;
+        std::fseek(f, static_cast<long>(at), SEEK_SET);
+        std::fputc(0x7f, f);
+        std::fclose(f);
+        EXPECT_EQ(FeedReader::open(path).error(), FileError::BAD_RECORD);
+
+        auto corrupt = records;
+        reinterpret_cast<unsigned char *>(&corrupt[50].event)[field] = 0x7f;
+
+        std::vector<LadderOrderbook> books;
+        books.emplace_back(256, 1024);
+        books.emplace_back(256, 1024);
+        const ReplayStats stats = replay_feed(std::span<LadderOrderbook>{books}, corrupt);
+        EXPECT_EQ(stats.skipped, 1u);
+        EXPECT_EQ(stats.messages, corrupt.size() - 1);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(FeedReplayTest, RejectsTimestampsThatGoBackwards)
+{
+    const std::string path = temp_feed_path("fiah_feed_backwards.bin");
+    auto records = make_synthetic_feed({.num_events = 100});
+    ASSERT_TRUE(write_feed(path, records));
+    ASSERT_TRUE(FeedReader::open(path));
+
+    records[60].timestamp_ns = records[59].timestamp_ns - 1;
+    ASSERT_TRUE(write_feed(path, records));
+    EXPECT_EQ(FeedReader::open(path).error(), FileError::BAD_RECORD);
+    std::remove(path.c_str());
+
+    // Paced replay of unchecked records treats an early timestamp as due now
+    records.front().timestamp_ns = 1'000;
+    records[1].timestamp_ns = 0;
+    Orderbook book;
+    const ReplayStats stats =
+        replay_feed(std::span<Orderbook>{&book, 1}, std::span<const FeedRecord>{records}.first(2), {.paced = true});
+    EXPECT_EQ(stats.messages, 2u);
+    EXPECT_LT(stats.elapsed_ns, 1'000'000'000u);
+}
+
+TEST(FeedReplayTest, WrittenRecordsHaveZeroedPadding)
+{
+    const std::string path = temp_feed_path("fiah_feed_padding.bin");
+    // Poison OrderEvent's tail padding in the source records
+    constexpr std::size_t TAIL = offsetof(OrderEvent, order_type) + sizeof(Order::Type);
+    std::vector<FeedRecord> records;
+    for (Id id = 1; id <= 3; ++id)
+    {
+        records.push_back({id, OrderEvent::add(0, Order{id, 100, true, 1})});
+        std::memset(reinterpret_cast<unsigned char *>(&records.back().event) + TAIL, 0xAB, sizeof(OrderEvent) - TAIL);
+    }
+    ASSERT_TRUE(write_feed(path, records));
+
+    auto feed = FeedReader::open(path);
+    ASSERT_TRUE(feed);
+    for (const FeedRecord &record : feed->records())
+        for (std::size_t b = TAIL; b < sizeof(OrderEvent); ++b)
+            EXPECT_EQ(reinterpret_cast<const unsigned char *>(&record.event)[b], 0u);
+    std::remove(path.c_str());
+}
+
+TEST(FeedReplayTest, NonPositiveMaxQtyIsClamped)
+{
+    for (const Quantity max_qty : {0, -5})
+    {
+        for (const FeedRecord &record : make_synthetic_feed({.num_events = 1'000, .max_qty = max_qty}))
+            EXPECT_EQ(record.event.qty, record.event.type == OrderEvent::Type::CANCEL ? 0 : 1);
+    }
+}
+
+TEST(FeedReplayTest, ReplayMatchesDirectApplication)
+{
+    const auto records = make_synthetic_feed({.num_events = 20'000, .num_symbols = 2, .depth = 16});
+
+    std::vector<LadderOrderbook> replayed(2);
+    const ReplayStats stats = replay_feed(std::span<LadderOrderbook>{replayed}, records);
+
+    std::vector<LadderOrderbook> direct(2);
+    std::vector<Orderbook> reference(2);
+    u64_t direct_trades = 0;
+    u64_t reference_trades = 0;
+    for (const FeedRecord &record : records)
+    {
+        apply_event(direct[record.event.symbol], record.event, [&](const Trade &) { ++direct_trades; });
+        apply_event(reference[record.event.symbol], record.event, [&](const Trade &) { ++reference_trades; });
+    }
+
+    EXPECT_EQ(stats.messages, records.size());
+    EXPECT_EQ(stats.skipped, 0u);
+    EXPECT_EQ(stats.trades, direct_trades);
+    EXPECT_EQ(stats.trades, reference_trades);
+    EXPECT_GT(stats.trades, 0u);
+    EXPECT_LE(stats.p50_ns, stats.p99_ns);
+    EXPECT_LE(stats.p99_ns, stats.max_ns);
+    for (std::size_t s = 0; s < direct.size(); ++s)
+    {
+        EXPECT_EQ(replayed[s].size(), direct[s].size());
+        ASSERT_TRUE(replayed[s].has_bids() && replayed[s].has_asks());
+        EXPECT_EQ(replayed[s].best_bid(), direct[s].best_bid());
+        EXPECT_EQ(replayed[s].best_ask(), direct[s].best_ask());
+    }
+}
+
+TEST(FeedReplayTest, PacedReplayFollowsTimestamps)
+{
+    std::vector<FeedRecord> records;
+    for (Id id = 1; id <= 5; ++id)
+        records.push_back({id * 1'000'000, OrderEvent::add(0, Order{id, 100 + static_cast<Price>(id), false, 1})});
+
+    Orderbook book;
+    const ReplayStats stats = replay_feed(std::span<Orderbook>{&book, 1}, records, {.paced = true});
+    EXPECT_EQ(stats.messages, 5u);
+    EXPECT_GE(stats.elapsed_ns, 4'000'000u); // last record is 4ms after the first
+}
@@ -0,0 +1,87 @@
+// clang-format off
+#include "fiah/structs/FlatIdMap.hh"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+
+#include "fiah/utils/XorBitant.hh"
+// clang-format on
+
+using namespace fiah;
+
+class FlatIdMapTest : public ::testing::Test
+{
+  protected:
+    FlatIdMap<sz_t, int> map{};
+};
+
+TEST_F(FlatIdMapTest, InsertFindErase)
+{
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(7), nullptr);
+
+    EXPECT_TRUE(map.insert(7, 70));
+    EXPECT_FALSE(map.insert(7, 71)); // no overwrite
+    ASSERT_NE(map.find(7), nullptr);
+    EXPECT_EQ(*map.find(7), 70);
+    EXPECT_EQ(map.size(), 1);
+
+    EXPECT_TRUE(map.erase(7));
+    EXPECT_FALSE(map.erase(7));
+    EXPECT_FALSE(map.contains(7));
+    EXPECT_TRUE(map.empty());
+}
+
+TEST_F(FlatIdMapTest, EmptyKeyIsNeverFound)
+{
+    EXPECT_TRUE(map.insert(7, 70));
+    EXPECT_EQ(map.find(decltype(map)::EMPTY_KEY), nullptr);
+    EXPECT_FALSE(map.contains(decltype(map)::EMPTY_KEY));
+    EXPECT_FALSE(map.erase(decltype(map)::EMPTY_KEY));
+    EXPECT_EQ(map.size(), 1);
+    EXPECT_TRUE(map.contains(7));
+}
+
+TEST_F(FlatIdMapTest, GrowsPastReservedSize)
+{
+    map.reserve(8);
+    const auto initial_capacity = map.capacity();
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_TRUE(map.insert(static_cast<sz_t>(i), i));
+
+    EXPECT_GT(map.capacity(), initial_capacity);
+    EXPECT_EQ(map.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(*map.find(static_cast<sz_t>(i)), i);
+}
+
+TEST_F(FlatIdMapTest, ChurnMatchesUnorderedMap)
+{
+    // Heavy insert/erase churn exercises backward-shift deletion across
+    // wrapped and overlapping probe runs.
+    std::unordered_map<sz_t, int> reference;
+    XorBitant rng{42};
+    map.reserve(256);
+    const auto reserved_capacity = map.capacity();
+
+    for (int i = 0; i < 200000; ++i)
+    {
+        const sz_t key = rng() % 512;
+        if (rng() % 2 == 0 && reference.size() < 256)
+            EXPECT_EQ(map.insert(key, i), reference.emplace(key, i).second);
+        else
+            EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+    }
+
+    EXPECT_EQ(map.size(), reference.size());
+    EXPECT_EQ(map.capacity(), reserved_capacity); // no tombstone-driven rehash
+    for (sz_t key = 0; key < 512; ++key)
+    {
+        auto it = reference.find(key);
+        if (it == reference.end())
+            EXPECT_FALSE(map.contains(key));
+        else
+            EXPECT_EQ(*map.find(key), it->second);
+    }
+}
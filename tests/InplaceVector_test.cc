@@ -0,0 +1,52 @@
+// clang-format off
+#include "fiah/structs/InplaceVector.hh"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <span>
+// clang-format on
+
+using namespace fiah;
+
+TEST(InplaceVectorTest, InsertEraseKeepOrder)
+{
+    InplaceVector<int, 4> v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), 4);
+
+    v.push_back(1);
+    v.push_back(3);
+    v.insert(v.begin() + 1, 2);
+    v.insert(v.begin(), 0);
+    EXPECT_TRUE(v.full());
+    EXPECT_TRUE(std::ranges::equal(v, std::array{0, 1, 2, 3}));
+    EXPECT_EQ(v.back(), 3);
+
+    auto it = v.erase(v.begin() + 1);
+    EXPECT_EQ(*it, 2);
+    EXPECT_TRUE(std::ranges::equal(v, std::array{0, 2, 3}));
+    v.pop_back();
+    const std::array reversed{2, 0};
+    EXPECT_TRUE(std::equal(v.rbegin(), v.rend(), reversed.begin(), reversed.end()));
+}
+
+TEST(InplaceVectorTest, AssignAndSpan)
+{
+    const std::array src{5, 6, 7};
+    InplaceVector<int, 8> v;
+    v.push_back(9);
+    v.assign(src.begin(), src.end());
+    const std::span<const int> view{v};
+    EXPECT_EQ(view.size(), 3);
+    EXPECT_EQ(view[2], 7);
+
+    // Copies are independent, since the storage is inline
+    InplaceVector<int, 8> copy = v;
+    copy[0] = 1;
+    EXPECT_EQ(v[0], 5);
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(copy.size(), 3);
+}
@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "fiah/engine/FeedReplay.hh"
+#include "fiah/engine/Journal.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/Orderbook.hh"
+
+using namespace fiah;
+
+namespace
+{
+std::string temp_path(const char *name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::vector<OrderEvent> make_events(u64_t n, u64_t seed)
+{
+    std::vector<OrderEvent> events;
+    for (const FeedRecord &record : make_synthetic_feed({.num_events = n, .depth = 16, .seed = seed}))
+        events.push_back(record.event);
+    return events;
+}
+
+/// Journals each event before applying it, the way a write-ahead log is used.
+template <class Book> void journal_and_apply(Book &book, Journal &journal, std::span<const OrderEvent> events)
+{
+    for (const OrderEvent &event : events)
+    {
+        ASSERT_NE(journal.append(event), 0);
+        apply_event(book, event, [](const Trade &) {});
+    }
+}
+
+/// Feeds the same events to both books and checks every trade matches.
+template <class Book> void expect_same_trades(Book &a, Book &b, std::span<const OrderEvent> events)
+{
+    for (const OrderEvent &event : events)
+    {
+        Trades expected;
+        Trades actual;
+        apply_event(a, event, [&](const Trade &t) { expected.push_back(t); });
+        apply_event(b, event, [&](const Trade &t) { actual.push_back(t); });
+        ASSERT_EQ(expected.size(), actual.size()) << "event id " << event.id;
+        for (std::size_t t = 0; t < expected.size(); ++t)
+        {
+            EXPECT_EQ(expected[t].OrderIdA, actual[t].OrderIdA);
+            EXPECT_EQ(expected[t].OrderIdB, actual[t].OrderIdB);
+            EXPECT_EQ(expected[t].Level, actual[t].Level);
+            EXPECT_EQ(expected[t].Size, actual[t].Size);
+        }
+    }
+}
+
+struct TempFiles
+{
+    std::string snapshot;
+    std::string journal;
+
+    ~TempFiles()
+    {
+        std::remove(snapshot.c_str());
+        std::remove(journal.c_str());
+    }
+};
+} // namespace
+
+TEST(JournalTest, FlushMakesAppendsDurableAndReadable)
+{
+    TempFiles files{"", temp_path("fiah_journal_flush.wal")};
+    const auto events = make_events(500, 1);
+    {
+        auto journal = Journal::create(files.journal, 1024);
+        ASSERT_TRUE(journal);
+        for (std::size_t i = 0; i < events.size(); ++i)
+            EXPECT_EQ((*journal)->append(events[i]), i + 1);
+        ASSERT_TRUE((*journal)->flush());
+        EXPECT_EQ((*journal)->durable_seq(), events.size());
+    }
+
+    auto reader = JournalReader::open(files.journal);
+    ASSERT_TRUE(reader);
+    const auto records = reader->records();
+    ASSERT_EQ(records.size(), events.size());
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        EXPECT_EQ(records[i].seq, i + 1);
+        EXPECT_EQ(records[i].event.id, events[i].id);
+        EXPECT_EQ(records[i].event.type, events[i].type);
+        EXPECT_EQ(records[i].event.price, events[i].price);
+    }
+}
+
+TEST(JournalTest, FlusherCommitsInTheBackground)
+{
+    TempFiles files{"", temp_path("fiah_journal_group.wal")};
+    auto journal = Journal::create(files.journal, 1024, 1, {.flush_interval = std::chrono::microseconds{200}});
+    ASSERT_TRUE(journal);
+
+    u64_t last = 0;
+    for (const OrderEvent &event : make_events(100, 2))
+        last = (*journal)->append(event);
+    EXPECT_TRUE((*journal)->wait_durable(last));
+    EXPECT_GE((*journal)->durable_seq(), last);
+}
+
+TEST(JournalTest, ReopenStopsAtTornRecordAndResumesThere)
+{
+    TempFiles files{"", temp_path("fiah_journal_torn.wal")};
+    const auto events = make_events(10, 3);
+    {
+        auto journal = Journal::create(files.journal, 64);
+        ASSERT_TRUE(journal);
+        for (const OrderEvent &event : events)
+            (void)(*journal)->append(event);
+    }
+
+    // Scribble over the checksum of record 7, as a torn write would
+    const int fd = ::open(files.journal.c_str(), O_WRONLY);
+    ASSERT_GE(fd, 0);
+    const u64_t garbage = 0xDEAD'BEEF;
+    const auto offset = sizeof(JournalHeader) + 6 * sizeof(JournalRecord) + offsetof(JournalRecord, check);
+    ASSERT_EQ(::pwrite(fd, &garbage, sizeof(garbage), static_cast<off_t>(offset)), sizeof(garbage));
+    ::close(fd);
+
+    auto journal = Journal::open(files.journal);
+    ASSERT_TRUE(journal);
+    EXPECT_EQ((*journal)->size(), 6);
+    EXPECT_EQ((*journal)->last_seq(), 6);
+    EXPECT_EQ((*journal)->append(events[6]), 7);
+}
+
+TEST(JournalTest, FullSegmentRejectsUntilReset)
+{
+    TempFiles files{"", temp_path("fiah_journal_full.wal")};
+    const auto events = make_events(8, 4);
+    auto journal = Journal::create(files.journal, 4);
+    ASSERT_TRUE(journal);
+    for (std::size_t i = 0; i < 4; ++i)
+        EXPECT_NE((*journal)->append(events[i]), 0);
+    EXPECT_EQ((*journal)->append(events[4]), 0);
+
+    EXPECT_EQ((*journal)->reset(3).error(), FileError::SEQ_GAP);
+    ASSERT_TRUE((*journal)->reset(5));
+    EXPECT_EQ((*journal)->size(), 0);
+    EXPECT_EQ((*journal)->append(events[4]), 5);
+    ASSERT_TRUE((*journal)->flush());
+
+    // Slots 1..3 still hold records from before the reset; none may count
+    auto reader = JournalReader::open(files.journal);
+    ASSERT_TRUE(reader);
+    EXPECT_EQ(reader->base_seq(), 5);
+    EXPECT_EQ(reader->records().size(), 1);
+}
+
+TEST(JournalTest, RejectsForeignFiles)
+{
+    EXPECT_EQ(Journal::open(temp_path("fiah_journal_missing.wal")).error(), FileError::OPEN_FAIL);
+
+    const std::string path = temp_path("fiah_journal_foreign.wal");
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::fputs("not a journal, but long enough to be mistaken for a header if nobody checked", f);
+    std::fclose(f);
+    EXPECT_EQ(Journal::open(path).error(), FileError::BAD_HEADER);
+    EXPECT_EQ(JournalReader::open(path).error(), FileError::BAD_HEADER);
+    std::remove(path.c_str());
+}
+
+template <class Book> class RecoveryTest : public ::testing::Test
+{
+};
+
+using RecoveryBooks = ::testing::Types<Orderbook, LadderOrderbook>;
+TYPED_TEST_SUITE(RecoveryTest, RecoveryBooks);
+
+TYPED_TEST(RecoveryTest, JournalAloneRebuildsTheBook)
+{
+    TempFiles files{temp_path("fiah_recovery_none.img"), temp_path("fiah_recovery_none.wal")};
+    const auto events = make_events(4000, 5);
+    TypeParam original{};
+    {
+        auto journal = Journal::create(files.journal, events.size());
+        ASSERT_TRUE(journal);
+        journal_and_apply(original, **journal, events);
+    }
+
+    auto recovered = recover_book<TypeParam>(files.snapshot, files.journal);
+    ASSERT_TRUE(recovered);
+    expect_same_trades(original, *recovered, make_events(4000, 6));
+}
+
+TYPED_TEST(RecoveryTest, ReplaysOnlyWhatTheSnapshotMissed)
+{
+    TempFiles files{temp_path("fiah_recovery_ckpt.img"), temp_path("fiah_recovery_ckpt.wal")};
+    const auto events = make_events(6000, 7);
+    const std::span<const OrderEvent> all{events};
+    TypeParam original{};
+    {
+        auto journal = Journal::create(files.journal, 4096);
+        ASSERT_TRUE(journal);
+        journal_and_apply(original, **journal, all.first(3000));
+        ASSERT_TRUE(checkpoint(original, **journal, files.snapshot));
+        EXPECT_EQ((*journal)->size(), 0);
+        journal_and_apply(original, **journal, all.subspan(3000));
+    }
+
+    std::vector<Trade> replayed;
+    auto recovered =
+        recover_book<TypeParam>(files.snapshot, files.journal, [&](const Trade &t) { replayed.push_back(t); });
+    ASSERT_TRUE(recovered);
+    expect_same_trades(original, *recovered, make_events(4000, 8));
+}
+
+TYPED_TEST(RecoveryTest, CrashBetweenSnapshotAndResetIsHarmless)
+{
+    TempFiles files{temp_path("fiah_recovery_crash.img"), temp_path("fiah_recovery_crash.wal")};
+    const auto events = make_events(3000, 9);
+    const std::span<const OrderEvent> all{events};
+    TypeParam original{};
+    {
+        auto journal = Journal::create(files.journal, events.size());
+        ASSERT_TRUE(journal);
+        journal_and_apply(original, **journal, all.first(2000));
+        // The snapshot lands but the journal is never reset
+        ASSERT_TRUE(original.save_snapshot(files.snapshot, (*journal)->last_seq()));
+        journal_and_apply(original, **journal, all.subspan(2000));
+    }
+
+    auto recovered = recover_book<TypeParam>(files.snapshot, files.journal);
+    ASSERT_TRUE(recovered);
+    expect_same_trades(original, *recovered, make_events(3000, 10));
+}
+
+TYPED_TEST(RecoveryTest, MissingEventsAreReported)
+{
+    TempFiles files{temp_path("fiah_recovery_gap.img"), temp_path("fiah_recovery_gap.wal")};
+    TypeParam original{};
+    ASSERT_TRUE(original.save_snapshot(files.snapshot, 5));
+    {
+        auto journal = Journal::create(files.journal, 16, 10);
+        ASSERT_TRUE(journal);
+        (void)(*journal)->append(OrderEvent::cancel(0, 1));
+    }
+    EXPECT_EQ(recover_book<TypeParam>(files.snapshot, files.journal).error(), FileError::SEQ_GAP);
+}
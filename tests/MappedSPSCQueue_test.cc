@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fiah/memory/PageMapping.hh"
+#include "fiah/structs/MappedSPSCQueue.hh"
+
+using namespace fiah;
+
+TEST(PageMappingTest, RoundsUpToWholePagesAndIsZeroed)
+{
+    auto mapping = PageMapping::map(100, {.pages = PageMode::DEFAULT});
+    ASSERT_TRUE(mapping);
+    EXPECT_EQ(mapping->mode(), PageMode::DEFAULT);
+    EXPECT_GE(mapping->size(), 100);
+    EXPECT_EQ(mapping->size() % static_cast<sz_t>(::sysconf(_SC_PAGESIZE)), 0);
+    EXPECT_TRUE(std::all_of(mapping->data(), mapping->data() + mapping->size(),
+                            [](std::byte b) { return b == std::byte{0}; }));
+
+    PageMapping moved = std::move(*mapping);
+    EXPECT_EQ(mapping->data(), nullptr);
+    moved.data()[moved.size() - 1] = std::byte{1};
+}
+
+TEST(PageMappingTest, HugePageModesFallBackRatherThanFail)
+{
+    // Without a hugetlbfs pool, HUGETLB degrades to THP; either way the
+    // mapping is whole 2 MiB pages
+    for (PageMode mode : {PageMode::TRANSPARENT_HUGE, PageMode::HUGETLB})
+    {
+        auto mapping = PageMapping::map(3 << 20, {.pages = mode});
+        ASSERT_TRUE(mapping);
+        EXPECT_NE(mapping->mode(), PageMode::DEFAULT);
+        EXPECT_EQ(mapping->size(), 4 << 20);
+    }
+}
+
+TEST(MappedSPSCQueueTest, CapacityIsRoundedToAPowerOfTwo)
+{
+    auto queue = MappedSPSCQueue<int>::create(1000, {.pages = PageMode::DEFAULT, .prefault = false});
+    ASSERT_TRUE(queue);
+    EXPECT_EQ((*queue)->capacity(), 1024);
+    EXPECT_EQ((*queue)->page_mode(), PageMode::DEFAULT);
+    EXPECT_EQ(MappedSPSCQueue<int>::create(0).value()->capacity(), 1);
+}
+
+TEST(MappedSPSCQueueTest, RejectsCapacitiesWhoseRingSizeOverflows)
+{
+    struct Wide
+    {
+        std::uint64_t words[8];
+    };
+    for (const std::uint64_t capacity : {std::numeric_limits<std::uint64_t>::max(), std::uint64_t{1} << 63,
+                                         (std::uint64_t{1} << 58) + 1})
+        EXPECT_EQ(MappedSPSCQueue<Wide>::create(capacity).error(), FileError::MMAP_FAIL) << capacity;
+}
+
+TEST(MappedSPSCQueueTest, FillDrainAndWrap)
+{
+    auto queue = MappedSPSCQueue<int>::create(8).value();
+    int out{-1};
+    EXPECT_FALSE(queue->pop(out));
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 8; ++i)
+            EXPECT_TRUE(queue->push(round * 8 + i));
+        EXPECT_TRUE(queue->full());
+        EXPECT_FALSE(queue->push(-1));
+        for (int i = 0; i < 8; ++i)
+        {
+            ASSERT_TRUE(queue->pop(out));
+            EXPECT_EQ(out, round * 8 + i);
+        }
+        EXPECT_TRUE(queue->empty());
+    }
+}
+
+TEST(MappedSPSCQueueTest, BulkAndZeroCopyOperations)
+{
+    auto queue = MappedSPSCQueue<std::string>::create(8).value();
+    const std::vector<std::string> words{"a-long-enough-string-to-allocate", "b", "c", "d", "e"};
+    std::vector<std::string> out(8);
+    for (int round = 0; round < 3; ++round) // wraps on the second round
+    {
+        EXPECT_EQ(queue->push_bulk(words), 5);
+        EXPECT_EQ(queue->pop_bulk(out), 5);
+        EXPECT_TRUE(std::ranges::equal(std::span<const std::string>{out}.first(5), words));
+    }
+
+    std::string *slot = queue->try_reserve();
+    ASSERT_NE(slot, nullptr);
+    slot->assign(words[0]);
+    queue->commit();
+    ASSERT_NE(queue->front(), nullptr);
+    EXPECT_EQ(*queue->front(), words[0]);
+    queue->release();
+    EXPECT_EQ(queue->front(), nullptr);
+
+    EXPECT_EQ(queue->push_bulk(words), 5); // left for the destructor
+}
+
+TEST(MappedSPSCQueueTest, TransfersInOrderAcrossThreads)
+{
+    constexpr u64_t COUNT{200'000};
+    auto queue = MappedSPSCQueue<u64_t>::create(1 << 10, {.pages = PageMode::HUGETLB}).value();
+    std::jthread producer{[&] {
+        for (u64_t i = 0; i < COUNT;)
+        {
+            if (queue->push(i))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    }};
+
+    u64_t received = 0;
+    u64_t out_of_order = 0;
+    u64_t value{};
+    while (received < COUNT)
+    {
+        if (queue->pop(value))
+            out_of_order += value != received++;
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+    EXPECT_EQ(out_of_order, 0);
+    EXPECT_TRUE(queue->empty());
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "test_utils.hh"
+#include "fiah/utils/Types.hh"
+#include "fiah/memory/ObjectPool.hh"
+
+using namespace fiah;
+
+class ObjectPoolTest : public ::testing::Test
+{
+protected:
+    struct Node
+    {
+        Node* next;
+        u64_t payload;
+    };
+};
+
+TEST_F(ObjectPoolTest, ExhaustsAtCapacity)
+{
+    ObjectPool<Node> pool{3};
+    Node* a = pool.create(Node{nullptr, 1});
+    Node* b = pool.create(Node{a, 2});
+    Node* c = pool.create(Node{b, 3});
+    ASSERT_NE(a, nullptr); ASSERT_NE(b, nullptr); ASSERT_NE(c, nullptr);
+    EXPECT_TRUE(pool.full());
+    EXPECT_EQ(pool.create(Node{}), nullptr);
+    EXPECT_EQ(c->next->next->payload, 1);
+}
+
+TEST_F(ObjectPoolTest, ReusesReleasedSlotsFirst)
+{
+    ObjectPool<Node> pool{4};
+    Node* a = pool.create(Node{nullptr, 1});
+    Node* b = pool.create(Node{nullptr, 2});
+    pool.destroy(a);
+    pool.destroy(b);
+    EXPECT_EQ(pool.in_use(), 0);
+
+    // LIFO free list: most recently released slot comes back first
+    EXPECT_EQ(pool.create(Node{nullptr, 3}), b);
+    EXPECT_EQ(pool.create(Node{nullptr, 4}), a);
+    EXPECT_EQ(pool.in_use(), 2);
+}
+
+TEST_F(ObjectPoolTest, NonTrivialType)
+{
+    ObjectPool<std::string> pool{2};
+    std::string* s = pool.create("a string long enough to defeat SSO, honestly");
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s->size(), 44);
+    pool.destroy(s);
+    EXPECT_EQ(pool.in_use(), 0);
+}
+
+TEST_F(ObjectPoolTest, MoveKeepsObjectsAlive)
+{
+    ObjectPool<Node> pool{2};
+    Node* a = pool.create(Node{nullptr, 7});
+    ObjectPool<Node> moved{std::move(pool)};
+    EXPECT_EQ(moved.in_use(), 1);
+    EXPECT_EQ(a->payload, 7);
+    moved.destroy(a);
+}
@@ -1,10 +1,19 @@
 
 // clang-format on
+#include "fiah/engine/OrderEvent.hh"
 #include "fiah/structs/Orderbook.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/SPSCQueue.hh"
+#include "fiah/structs/SoAOrderbook.hh"
+#include "fiah/structs/Vector.hh"
+#include "fiah/utils/XorBitant.hh"
 
 #include <algorithm>
+#include <array>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <print>
 #include <ranges>
 // clang-format off
@@ -66,4 +75,712 @@ TEST_F(OrderbookTest, AddOrdersAndGenerateTrades)
     });
 
     EXPECT_FALSE(trades.empty());
-}
\ No newline at end of file
+}
+
+template <class Book> class OrderbookImplTest : public ::testing::Test
+{
+  protected:
+    Book book{};
+};
+
+using OrderbookImpls = ::testing::Types<Orderbook, fiah::LadderOrderbook, fiah::SoAOrderbook>;
+TYPED_TEST_SUITE(OrderbookImplTest, OrderbookImpls);
+
+TYPED_TEST(OrderbookImplTest, BuyAggressorTradesAtRestingAskPrice)
+{
+    EXPECT_TRUE(this->book.AddOrder(Order{1, 100, false, 10}).empty());
+
+    Trades trades = this->book.AddOrder(Order{2, 101, true, 4});
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].OrderIdA, 2);
+    EXPECT_EQ(trades[0].OrderIdB, 1);
+    EXPECT_EQ(trades[0].AggressorOrderId, 2);
+    EXPECT_TRUE(trades[0].AggressorIsBuy);
+    EXPECT_EQ(trades[0].Level, 100);
+    EXPECT_EQ(trades[0].Size, 4);
+}
+
+TYPED_TEST(OrderbookImplTest, SellAggressorTradesAtIncomingPrice)
+{
+    EXPECT_TRUE(this->book.AddOrder(Order{1, 105, true, 3}).empty());
+
+    Trades trades = this->book.AddOrder(Order{2, 100, false, 5});
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].OrderIdA, 1);
+    EXPECT_EQ(trades[0].OrderIdB, 2);
+    EXPECT_FALSE(trades[0].AggressorIsBuy);
+    EXPECT_EQ(trades[0].Level, 100);
+    EXPECT_EQ(trades[0].Size, 3);
+
+    // Remaining 2 rests as the new best ask
+    trades = this->book.AddOrder(Order{3, 100, true, 2});
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].OrderIdB, 2);
+    EXPECT_EQ(trades[0].Size, 2);
+}
+
+TYPED_TEST(OrderbookImplTest, TimePriorityWithinLevel)
+{
+    (void)this->book.AddOrder(Order{1, 100, false, 2});
+    (void)this->book.AddOrder(Order{2, 100, false, 2});
+    (void)this->book.AddOrder(Order{3, 100, false, 2});
+
+    Trades trades = this->book.AddOrder(Order{4, 100, true, 5});
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_EQ(trades[0].OrderIdB, 1);
+    EXPECT_EQ(trades[1].OrderIdB, 2);
+    EXPECT_EQ(trades[2].OrderIdB, 3);
+    EXPECT_EQ(trades[2].Size, 1);
+}
+
+TYPED_TEST(OrderbookImplTest, SweepsLevelsBestFirst)
+{
+    (void)this->book.AddOrder(Order{1, 103, false, 1});
+    (void)this->book.AddOrder(Order{2, 101, false, 1});
+    (void)this->book.AddOrder(Order{3, 102, false, 1});
+
+    Trades trades = this->book.AddOrder(Order{4, 102, true, 3});
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].Level, 101);
+    EXPECT_EQ(trades[1].Level, 102);
+
+    // The leftover unit rests at 102 and does not cross 103
+    EXPECT_TRUE(this->book.is_dupe(Order{4, 0, true, 0}));
+}
+
+TYPED_TEST(OrderbookImplTest, DuplicateIdIsIgnored)
+{
+    (void)this->book.AddOrder(Order{1, 100, false, 1});
+    EXPECT_TRUE(this->book.AddOrder(Order{1, 100, true, 1}).empty());
+    EXPECT_TRUE(this->book.is_dupe(Order{1, 100, false, 1}));
+}
+
+TYPED_TEST(OrderbookImplTest, ReservedIdIsRejected)
+{
+    const Id reserved = TypeParam::RESERVED_ID;
+    EXPECT_FALSE(this->book.is_dupe(Order{reserved, 100, false, 1}));
+    EXPECT_TRUE(this->book.AddOrder(Order{reserved, 100, false, 5}).empty());
+    EXPECT_FALSE(this->book.is_dupe(Order{reserved, 100, false, 1}));
+
+    // Neither rested nor usable through cancel/modify
+    this->book.CancelOrder(reserved);
+    EXPECT_TRUE(this->book.ModifyOrder(reserved, 3, 99).empty());
+    EXPECT_TRUE(this->book.AddOrder(Order{1, 100, true, 5}).empty());
+
+    // As an aggressor it does not trade either
+    EXPECT_TRUE(this->book.AddOrder(Order{reserved, 100, false, 5}).empty());
+    Trades trades = this->book.AddOrder(Order{2, 100, false, 5});
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].OrderIdA, 1);
+    EXPECT_EQ(trades[0].Size, 5);
+}
+
+TYPED_TEST(OrderbookImplTest, CancelRemovesRestingOrder)
+{
+    (void)this->book.AddOrder(Order{1, 100, false, 1});
+    (void)this->book.AddOrder(Order{2, 101, false, 1});
+    this->book.CancelOrder(1);
+    this->book.CancelOrder(42); // unknown id is a no-op
+
+    EXPECT_FALSE(this->book.is_dupe(Order{1, 100, false, 1}));
+    Trades trades = this->book.AddOrder(Order{3, 101, true, 2});
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].OrderIdB, 2);
+}
+
+TEST(LadderOrderbookTest, MatchesVectorBookOnRandomFlow)
+{
+    Orderbook reference;
+    fiah::LadderOrderbook ladder{1 << 8};
+    fiah::XorBitant rng{0xC0FFEE};
+
+    Id next_id = 1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        Trades expected;
+        Trades actual;
+        const auto action = rng() % 8;
+        if (next_id > 1 && action < 2)
+        {
+            Id victim = 1 + rng() % (next_id - 1);
+            reference.CancelOrder(victim);
+            ladder.CancelOrder(victim);
+            continue;
+        }
+        if (next_id > 1 && action < 4)
+        {
+            Id target = 1 + rng() % (next_id - 1);
+            Quantity qty = static_cast<Quantity>(rng() % 20);
+            Price price = 1000 + static_cast<Price>(rng() % 64);
+            expected = reference.ModifyOrder(target, qty, price);
+            actual = ladder.ModifyOrder(target, qty, price);
+        }
+        else
+        {
+            Order order{next_id++, 1000 + static_cast<Price>(rng() % 64), (rng() & 1) != 0,
+                        1 + static_cast<Quantity>(rng() % 20)};
+            expected = reference.AddOrder(order);
+            actual = ladder.AddOrder(order);
+        }
+        ASSERT_EQ(expected.size(), actual.size()) << "step " << i;
+        for (std::size_t t = 0; t < expected.size(); ++t)
+        {
+            EXPECT_EQ(expected[t].OrderIdA, actual[t].OrderIdA);
+            EXPECT_EQ(expected[t].OrderIdB, actual[t].OrderIdB);
+            EXPECT_EQ(expected[t].AggressorIsBuy, actual[t].AggressorIsBuy);
+            EXPECT_EQ(expected[t].Level, actual[t].Level);
+            EXPECT_EQ(expected[t].Size, actual[t].Size);
+        }
+    }
+}
+
+TEST(LadderOrderbookTest, WindowSlidesToFollowPrice)
+{
+    fiah::LadderOrderbook ladder{64};
+    ASSERT_EQ(ladder.num_levels(), 64);
+    (void)ladder.AddOrder(Order{1, 1000, true, 1});
+    (void)ladder.AddOrder(Order{2, 1040, false, 1});
+    EXPECT_EQ(ladder.best_bid(), 1000);
+    EXPECT_EQ(ladder.best_ask(), 1040);
+
+    // 1090 is outside the current window but the live span still fits in 64 ticks
+    (void)ladder.AddOrder(Order{3, 1042, false, 1});
+    ladder.CancelOrder(1);
+    (void)ladder.AddOrder(Order{4, 1090, false, 1});
+    EXPECT_TRUE(ladder.is_dupe(Order{4, 0, false, 0}));
+
+    // Too far away to share a window with the resting asks
+    (void)ladder.AddOrder(Order{5, 5000, false, 1});
+    EXPECT_FALSE(ladder.is_dupe(Order{5, 0, false, 0}));
+
+    Trades trades = ladder.AddOrder(Order{6, 1090, true, 3});
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_EQ(trades[0].Level, 1040);
+    EXPECT_EQ(trades[1].Level, 1042);
+    EXPECT_EQ(trades[2].Level, 1090);
+    EXPECT_FALSE(ladder.has_asks());
+}
+
+TEST(LadderOrderbookTest, DropsRemainderWhenPoolIsFull)
+{
+    fiah::LadderOrderbook ladder{64, 2};
+    (void)ladder.AddOrder(Order{1, 100, false, 1});
+    (void)ladder.AddOrder(Order{2, 101, false, 1});
+    (void)ladder.AddOrder(Order{3, 102, false, 1});
+    EXPECT_EQ(ladder.size(), 2);
+    EXPECT_FALSE(ladder.is_dupe(Order{3, 0, false, 0}));
+
+    // Freed nodes are recycled
+    ladder.CancelOrder(1);
+    (void)ladder.AddOrder(Order{3, 102, false, 1});
+    EXPECT_TRUE(ladder.is_dupe(Order{3, 0, false, 0}));
+    EXPECT_EQ(ladder.best_ask(), 101);
+}
+
+TYPED_TEST(OrderbookImplTest, SinkReceivesSameTradesAsVector)
+{
+    TypeParam reference{};
+    fiah::Vector<Trade> sunk;
+    sunk.reserve(8);
+
+    for (Id id = 1; id <= 6; ++id)
+    {
+        const Order resting{id, 100 + static_cast<Price>(id), false, 2};
+        (void)reference.AddOrder(resting);
+        this->book.AddOrder(resting, [](const Trade &) { FAIL() << "nothing to match"; });
+    }
+
+    const Order sweep{10, 104, true, 7};
+    Trades expected = reference.AddOrder(sweep);
+
+    sunk.clear();
+    this->book.AddOrder(sweep, [&sunk](const Trade &trade) { sunk.push_back(trade); });
+    ASSERT_EQ(sunk.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(sunk[i].OrderIdB, expected[i].OrderIdB);
+        EXPECT_EQ(sunk[i].Size, expected[i].Size);
+    }
+    EXPECT_EQ(sunk.capacity(), 8); // reused buffer, no regrowth
+}
+
+TYPED_TEST(OrderbookImplTest, SinkCanPublishToSPSCQueue)
+{
+    fiah::SPSCQueue<Trade, 16> egress;
+    auto publish = [&egress](const Trade &trade) { (void)egress.push(trade); };
+
+    this->book.AddOrder(Order{1, 100, true, 5}, publish);
+    this->book.AddOrder(Order{2, 99, false, 3}, publish);
+    this->book.AddOrder(Order{3, 100, false, 3}, publish);
+
+    ASSERT_EQ(egress.size(), 2);
+    Trade out{};
+    ASSERT_TRUE(egress.pop(out));
+    EXPECT_EQ(out.OrderIdB, 2);
+    EXPECT_EQ(out.Size, 3);
+    ASSERT_TRUE(egress.pop(out));
+    EXPECT_EQ(out.OrderIdB, 3);
+    EXPECT_EQ(out.Size, 2);
+}
+
+TYPED_TEST(OrderbookImplTest, ModifyDownKeepsPriority)
+{
+    (void)this->book.AddOrder(Order{1, 100, false, 5});
+    (void)this->book.AddOrder(Order{2, 100, false, 5});
+    EXPECT_TRUE(this->book.ModifyOrder(1, 2, 100).empty());
+
+    Trades trades = this->book.AddOrder(Order{3, 100, true, 3});
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].OrderIdB, 1);
+    EXPECT_EQ(trades[0].Size, 2);
+    EXPECT_EQ(trades[1].OrderIdB, 2);
+}
+
+TYPED_TEST(OrderbookImplTest, ModifyUpLosesPriority)
+{
+    (void)this->book.AddOrder(Order{1, 100, false, 5});
+    (void)this->book.AddOrder(Order{2, 100, false, 5});
+    EXPECT_TRUE(this->book.ModifyOrder(1, 6, 100).empty());
+
+    Trades trades = this->book.AddOrder(Order{3, 100, true, 6});
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].OrderIdB, 2);
+    EXPECT_EQ(trades[1].OrderIdB, 1);
+    EXPECT_EQ(trades[1].Size, 1);
+}
+
+TYPED_TEST(OrderbookImplTest, ModifyPriceCanTrade)
+{
+    (void)this->book.AddOrder(Order{1, 105, false, 5});
+    (void)this->book.AddOrder(Order{2, 100, true, 3});
+
+    // Bid moves up through the ask; the amended order is the aggressor
+    Trades trades = this->book.ModifyOrder(2, 8, 106);
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].OrderIdA, 2);
+    EXPECT_EQ(trades[0].AggressorOrderId, 2);
+    EXPECT_EQ(trades[0].Level, 105);
+    EXPECT_EQ(trades[0].Size, 5);
+
+    // Remainder rests at the new price
+    trades = this->book.AddOrder(Order{3, 106, false, 10});
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].OrderIdA, 2);
+    EXPECT_EQ(trades[0].Size, 3);
+}
+
+TYPED_TEST(OrderbookImplTest, ModifyToZeroCancelsAndUnknownIsIgnored)
+{
+    (void)this->book.AddOrder(Order{1, 100, false, 5});
+    EXPECT_TRUE(this->book.ModifyOrder(7, 1, 100).empty());
+    EXPECT_TRUE(this->book.ModifyOrder(1, 0, 100).empty());
+    EXPECT_FALSE(this->book.is_dupe(Order{1, 100, false, 5}));
+}
+
+TEST(LadderOrderbookTest, TopLevelsTracksAggregates)
+{
+    fiah::LadderOrderbook ladder{256};
+    (void)ladder.AddOrder(Order{1, 100, true, 5});
+    (void)ladder.AddOrder(Order{2, 100, true, 7});
+    (void)ladder.AddOrder(Order{3, 30, true, 1}); // more than one bitmap word away
+    (void)ladder.AddOrder(Order{4, 99, true, 2});
+    (void)ladder.AddOrder(Order{5, 104, false, 4});
+    (void)ladder.AddOrder(Order{6, 180, false, 9});
+
+    std::array<fiah::DepthLevel, 4> bids{};
+    ASSERT_EQ(ladder.top_levels(Order::Side::BUY, bids), 3);
+    EXPECT_EQ(bids[0].price, 100);
+    EXPECT_EQ(bids[0].qty, 12);
+    EXPECT_EQ(bids[0].count, 2);
+    EXPECT_EQ(bids[1].price, 99);
+    EXPECT_EQ(bids[2].price, 30);
+
+    // Fill, in-place amend and cancel all update the aggregates
+    (void)ladder.AddOrder(Order{7, 100, false, 3});
+    (void)ladder.ModifyOrder(2, 4, 100);
+    ladder.CancelOrder(4);
+    ASSERT_EQ(ladder.top_levels(Order::Side::BUY, std::span{bids}.first(2)), 2);
+    EXPECT_EQ(bids[0].qty, 2 + 4);
+    EXPECT_EQ(bids[0].count, 2);
+    EXPECT_EQ(bids[1].price, 30);
+
+    std::array<fiah::DepthLevel, 1> asks{};
+    ASSERT_EQ(ladder.top_levels(Order::Side::SELL, asks), 1);
+    EXPECT_EQ(asks[0].price, 104);
+    EXPECT_EQ(asks[0].qty, 4);
+
+    // Sweeping the best ask level moves the cursor across the gap
+    (void)ladder.AddOrder(Order{8, 104, true, 4});
+    ASSERT_EQ(ladder.top_levels(Order::Side::SELL, asks), 1);
+    EXPECT_EQ(asks[0].price, 180);
+    EXPECT_EQ(ladder.best_ask(), 180);
+}
+
+TYPED_TEST(OrderbookImplTest, TopLevelsAgreeWithLadder)
+{
+    fiah::LadderOrderbook reference{256};
+    fiah::XorBitant rng{17};
+    for (Id id = 1; id <= 2000; ++id)
+    {
+        const auto action = rng() % 8;
+        if (action < 2)
+        {
+            const Id victim = 1 + rng() % id;
+            this->book.CancelOrder(victim);
+            reference.CancelOrder(victim);
+            continue;
+        }
+        if (action == 2) // shrinks in place, re-prices or grows
+        {
+            const Id victim = 1 + rng() % id;
+            const auto qty = static_cast<Quantity>(rng() % 12);
+            const auto price = 1000 + static_cast<Price>(rng() % 32);
+            (void)this->book.ModifyOrder(victim, qty, price);
+            (void)reference.ModifyOrder(victim, qty, price);
+            continue;
+        }
+        const Order order{id, 1000 + static_cast<Price>(rng() % 32), (rng() & 1) != 0,
+                          1 + static_cast<Quantity>(rng() % 10)};
+        (void)this->book.AddOrder(order);
+        (void)reference.AddOrder(order);
+    }
+
+    for (const auto side : {Order::Side::BUY, Order::Side::SELL})
+    {
+        std::array<fiah::DepthLevel, 5> expected{};
+        std::array<fiah::DepthLevel, 5> actual{};
+        const auto n = reference.top_levels(side, expected);
+        ASSERT_EQ(this->book.top_levels(side, actual), n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(actual[i].price, expected[i].price);
+            EXPECT_EQ(actual[i].qty, expected[i].qty);
+            EXPECT_EQ(actual[i].count, expected[i].count);
+        }
+    }
+}
+
+TYPED_TEST(OrderbookImplTest, CancelHeavyFlowWithReusedIdsAgreesWithLadder)
+{
+    // 90% cancels over a small id pool, so cancelled ids come straight back
+    // while their old orders may still be waiting to be cleaned up
+    fiah::LadderOrderbook reference{256};
+    fiah::XorBitant rng{0xCA7};
+    for (int step = 0; step < 50000; ++step)
+    {
+        const Id id = 1 + rng() % 64;
+        const auto action = rng() % 20;
+        Trades expected;
+        Trades actual;
+        if (action < 18)
+        {
+            this->book.CancelOrder(id);
+            reference.CancelOrder(id);
+        }
+        else if (action == 18)
+        {
+            const auto qty = static_cast<Quantity>(rng() % 12);
+            const auto price = 1000 + static_cast<Price>(rng() % 32);
+            expected = reference.ModifyOrder(id, qty, price);
+            actual = this->book.ModifyOrder(id, qty, price);
+        }
+        else
+        {
+            const Order order{id, 1000 + static_cast<Price>(rng() % 32), (rng() & 1) != 0,
+                              1 + static_cast<Quantity>(rng() % 10)};
+            expected = reference.AddOrder(order);
+            actual = this->book.AddOrder(order);
+        }
+        ASSERT_EQ(actual.size(), expected.size()) << "step " << step;
+        for (std::size_t t = 0; t < expected.size(); ++t)
+        {
+            EXPECT_EQ(actual[t].OrderIdA, expected[t].OrderIdA);
+            EXPECT_EQ(actual[t].OrderIdB, expected[t].OrderIdB);
+            EXPECT_EQ(actual[t].Size, expected[t].Size);
+        }
+        ASSERT_EQ(this->book.size(), reference.size()) << "step " << step;
+    }
+
+    for (const auto side : {Order::Side::BUY, Order::Side::SELL})
+    {
+        std::array<fiah::DepthLevel, 8> expected{};
+        std::array<fiah::DepthLevel, 8> actual{};
+        const auto n = reference.top_levels(side, expected);
+        ASSERT_EQ(this->book.top_levels(side, actual), n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(actual[i].price, expected[i].price);
+            EXPECT_EQ(actual[i].qty, expected[i].qty);
+        }
+    }
+}
+
+TYPED_TEST(OrderbookImplTest, BatchMatchesSequential)
+{
+    TypeParam sequential{};
+    fiah::XorBitant rng{99};
+    Orders batch;
+    for (Id id = 1; id <= 256; ++id)
+        batch.emplace_back(id, 500 + static_cast<Price>(rng() % 40), (rng() & 1) != 0,
+                           1 + static_cast<Quantity>(rng() % 10));
+
+    Trades expected;
+    for (const Order &order : batch)
+        sequential.AddOrder(order, [&expected](const Trade &trade) { expected.push_back(trade); });
+
+    Trades actual;
+    this->book.AddOrders(batch, [&actual](const Trade &trade) { actual.push_back(trade); });
+
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(actual[i].OrderIdA, expected[i].OrderIdA);
+        EXPECT_EQ(actual[i].OrderIdB, expected[i].OrderIdB);
+        EXPECT_EQ(actual[i].Level, expected[i].Level);
+        EXPECT_EQ(actual[i].Size, expected[i].Size);
+    }
+}
+
+TYPED_TEST(OrderbookImplTest, IocFillsWhatCrossesAndNeverRests)
+{
+    (void)this->book.AddOrder(Order{1, 100, false, 3});
+    (void)this->book.AddOrder(Order{2, 102, false, 3});
+
+    Trades trades = this->book.AddOrder(Order{3, 101, true, 5, Order::Type::IOC});
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].Size, 3);
+    EXPECT_FALSE(this->book.is_dupe(Order{3, 0, true, 0}));
+
+    // Nothing crosses: no trade, no resting order
+    EXPECT_TRUE(this->book.AddOrder(Order{4, 101, true, 1, Order::Type::IOC}).empty());
+    EXPECT_FALSE(this->book.is_dupe(Order{4, 0, true, 0}));
+}
+
+TYPED_TEST(OrderbookImplTest, FokIsAllOrNothing)
+{
+    (void)this->book.AddOrder(Order{1, 100, false, 2});
+    (void)this->book.AddOrder(Order{2, 101, false, 2});
+    (void)this->book.AddOrder(Order{3, 103, false, 10});
+
+    // 4 units cross at <= 101, 5 are wanted: kill without touching the book
+    EXPECT_TRUE(this->book.AddOrder(Order{4, 101, true, 5, Order::Type::FOK}).empty());
+    EXPECT_FALSE(this->book.is_dupe(Order{4, 0, true, 0}));
+    EXPECT_TRUE(this->book.is_dupe(Order{1, 0, false, 0}));
+
+    Trades trades = this->book.AddOrder(Order{5, 101, true, 4, Order::Type::FOK});
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].Level, 100);
+    EXPECT_EQ(trades[1].Level, 101);
+    EXPECT_FALSE(this->book.is_dupe(Order{2, 0, false, 0}));
+
+    // Sell side: bids 99 x1 and 98 x1 cover a 2-lot down to 98
+    (void)this->book.AddOrder(Order{6, 99, true, 1});
+    (void)this->book.AddOrder(Order{7, 98, true, 1});
+    EXPECT_TRUE(this->book.AddOrder(Order{8, 99, false, 2, Order::Type::FOK}).empty());
+    EXPECT_EQ(this->book.AddOrder(Order{9, 98, false, 2, Order::Type::FOK}).size(), 2);
+}
+
+TYPED_TEST(OrderbookImplTest, FokCountsLiquidityNearQuantityMax)
+{
+    constexpr Quantity BIG = std::numeric_limits<Quantity>::max() - 10;
+    (void)this->book.AddOrder(Order{1, 100, false, BIG});
+    (void)this->book.AddOrder(Order{2, 101, false, BIG});
+
+    // The two levels together hold more than Quantity can count
+    Trades trades = this->book.AddOrder(Order{3, 101, true, std::numeric_limits<Quantity>::max(), Order::Type::FOK});
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].Size, BIG);
+    EXPECT_EQ(trades[1].Size, 10);
+
+    // One level of BIG cannot cover the max
+    (void)this->book.AddOrder(Order{4, 99, true, BIG});
+    EXPECT_TRUE(
+        this->book.AddOrder(Order{5, 99, false, std::numeric_limits<Quantity>::max(), Order::Type::FOK}).empty());
+    EXPECT_TRUE(this->book.is_dupe(Order{4, 0, true, 0}));
+}
+
+TYPED_TEST(OrderbookImplTest, MarketOrderSweepsAtRestingPrices)
+{
+    (void)this->book.AddOrder(Order{1, 100, false, 1});
+    (void)this->book.AddOrder(Order{2, 250, false, 1});
+
+    Trades trades = this->book.AddOrder(Order{3, 0, true, 5, Order::Type::MARKET});
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].Level, 100);
+    EXPECT_EQ(trades[1].Level, 250);
+    EXPECT_FALSE(this->book.is_dupe(Order{3, 0, true, 0}));
+
+    (void)this->book.AddOrder(Order{4, 90, true, 2});
+    trades = this->book.AddOrder(Order{5, 0, false, 1, Order::Type::MARKET});
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].Level, 90); // market sell takes the bid's price
+    EXPECT_EQ(trades[0].OrderIdA, 4);
+
+    // Empty opposite side: nothing happens
+    EXPECT_TRUE(this->book.AddOrder(Order{6, 0, true, 1, Order::Type::MARKET}).empty());
+}
+
+TEST(OrderEventTest, CarriesOrderType)
+{
+    fiah::LadderOrderbook book;
+    (void)book.AddOrder(Order{1, 100, false, 1});
+    std::size_t trades = 0;
+    auto count = [&trades](const Trade &) { ++trades; };
+    fiah::apply_event(book, fiah::OrderEvent::add(0, Order{2, 100, true, 3, Order::Type::IOC}), count);
+    EXPECT_EQ(trades, 1);
+    EXPECT_FALSE(book.is_dupe(Order{2, 0, true, 0}));
+}
+
+TEST(SoAOrderbookTest, MatchesVectorBookOnRandomFlow)
+{
+    Orderbook reference;
+    fiah::SoAOrderbook soa;
+    fiah::XorBitant rng{0x50A};
+    constexpr std::array types{Order::Type::LIMIT, Order::Type::LIMIT, Order::Type::LIMIT,
+                               Order::Type::IOC,   Order::Type::FOK,   Order::Type::MARKET};
+
+    Id next_id = 1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        Trades expected;
+        Trades actual;
+        const auto action = rng() % 8;
+        if (next_id > 1 && action < 2)
+        {
+            Id victim = 1 + rng() % (next_id - 1);
+            reference.CancelOrder(victim);
+            soa.CancelOrder(victim);
+            continue;
+        }
+        if (next_id > 1 && action < 3)
+        {
+            Id target = 1 + rng() % (next_id - 1);
+            Quantity qty = static_cast<Quantity>(rng() % 20);
+            Price price = 1000 + static_cast<Price>(rng() % 64);
+            expected = reference.ModifyOrder(target, qty, price);
+            actual = soa.ModifyOrder(target, qty, price);
+        }
+        else
+        {
+            // Mostly small passive orders, with the odd large sweep that eats
+            // dozens of resting orders across many levels
+            const bool sweep = rng() % 32 == 0;
+            Order order{next_id++, 1000 + static_cast<Price>(rng() % 64), (rng() & 1) != 0,
+                        1 + static_cast<Quantity>(rng() % (sweep ? 400 : 8)), types[rng() % types.size()]};
+            expected = reference.AddOrder(order);
+            actual = soa.AddOrder(order);
+        }
+        ASSERT_EQ(expected.size(), actual.size()) << "step " << i;
+        for (std::size_t t = 0; t < expected.size(); ++t)
+        {
+            EXPECT_EQ(expected[t].OrderIdA, actual[t].OrderIdA);
+            EXPECT_EQ(expected[t].OrderIdB, actual[t].OrderIdB);
+            EXPECT_EQ(expected[t].AggressorIsBuy, actual[t].AggressorIsBuy);
+            EXPECT_EQ(expected[t].Level, actual[t].Level);
+            EXPECT_EQ(expected[t].Size, actual[t].Size);
+        }
+    }
+}
+
+TEST(CompactOrderbookTest, PacksFourOrdersPerCacheLine)
+{
+    using Book = CompactOrderbook<>;
+    EXPECT_EQ(sizeof(Book::order_type), 16);
+    EXPECT_EQ(sizeof(Order), 24);
+    static_assert(std::is_same_v<Orderbook::trade_type, Trade>);
+    static_assert(std::is_same_v<decltype(Book::trade_type::Level), std::int32_t>);
+}
+
+TEST(CompactOrderbookTest, RejectsOffTickPrices)
+{
+    CompactOrderbook<5, 16> book;
+    using O = CompactOrderbook<5, 16>::order_type;
+    (void)book.AddOrder(O{1, 101, false, 5});
+    EXPECT_EQ(book.size(), 0);
+    (void)book.AddOrder(O{2, 100, false, 5});
+    EXPECT_EQ(book.size(), 1);
+
+    // A market order has no price of its own to check
+    auto trades = book.AddOrder(O{3, 1, true, 2, Order::Type::MARKET});
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].Level, 100);
+
+    // An off-tick modify leaves the order untouched
+    EXPECT_TRUE(book.ModifyOrder(2, 3, 103).empty());
+    std::array<CompactOrderbook<5, 16>::depth_level_type, 1> top{};
+    ASSERT_EQ(book.top_levels(Order::Side::SELL, top), 1);
+    EXPECT_EQ(top[0].price, 100);
+    EXPECT_EQ(top[0].qty, 3);
+}
+
+TEST(CompactOrderbookTest, DropsRemainderWhenSideIsFull)
+{
+    CompactOrderbook<1, 2> book;
+    using O = CompactOrderbook<1, 2>::order_type;
+    (void)book.AddOrder(O{1, 100, false, 1});
+    (void)book.AddOrder(O{2, 101, false, 1});
+    (void)book.AddOrder(O{3, 102, false, 1});
+    EXPECT_EQ(book.size(), 2);
+    EXPECT_FALSE(book.is_dupe(O{3, 0, false, 0}));
+
+    // The other side has its own capacity, and a fill frees a slot
+    (void)book.AddOrder(O{4, 99, true, 1});
+    EXPECT_EQ(book.size(), 3);
+    EXPECT_EQ(book.AddOrder(O{5, 100, true, 1}).size(), 1);
+    (void)book.AddOrder(O{3, 102, false, 1});
+    EXPECT_TRUE(book.is_dupe(O{3, 0, false, 0}));
+}
+
+TEST(CompactOrderbookTest, MatchesVectorBookOnRandomFlow)
+{
+    using Book = CompactOrderbook<5, 4096>;
+    using O = Book::order_type;
+    Orderbook reference;
+    auto compact = std::make_unique<Book>();
+    fiah::XorBitant rng{0x16B};
+    constexpr std::array types{Order::Type::LIMIT, Order::Type::LIMIT, Order::Type::LIMIT,
+                               Order::Type::IOC,   Order::Type::FOK,   Order::Type::MARKET};
+
+    std::uint32_t next_id = 1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        Trades expected;
+        Book::trades_type actual;
+        const auto action = rng() % 8;
+        if (next_id > 1 && action < 2)
+        {
+            const auto victim = static_cast<std::uint32_t>(1 + rng() % (next_id - 1));
+            reference.CancelOrder(victim);
+            compact->CancelOrder(victim);
+            continue;
+        }
+        // Every price is on the 5-tick grid, so both books see the same flow
+        const auto price = static_cast<std::int32_t>(5 * (200 + rng() % 64));
+        if (next_id > 1 && action < 3)
+        {
+            const auto target = static_cast<std::uint32_t>(1 + rng() % (next_id - 1));
+            const auto qty = static_cast<std::int32_t>(rng() % 20);
+            expected = reference.ModifyOrder(target, qty, price);
+            actual = compact->ModifyOrder(target, qty, price);
+        }
+        else
+        {
+            const auto qty = static_cast<std::int32_t>(1 + rng() % 20);
+            const bool is_buy = (rng() & 1) != 0;
+            const auto type = types[rng() % types.size()];
+            expected = reference.AddOrder(Order{next_id, price, is_buy, qty, type});
+            actual = compact->AddOrder(O{next_id, price, is_buy, qty, type});
+            ++next_id;
+        }
+        ASSERT_EQ(expected.size(), actual.size()) << "step " << i;
+        for (std::size_t t = 0; t < expected.size(); ++t)
+        {
+            EXPECT_EQ(expected[t].OrderIdA, actual[t].OrderIdA);
+            EXPECT_EQ(expected[t].OrderIdB, actual[t].OrderIdB);
+            EXPECT_EQ(expected[t].AggressorIsBuy, actual[t].AggressorIsBuy);
+            EXPECT_EQ(expected[t].Level, actual[t].Level);
+            EXPECT_EQ(expected[t].Size, actual[t].Size);
+        }
+    }
+    EXPECT_EQ(reference.size(), compact->size());
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "fiah/structs/OverwriteRing.hh"
+
+using namespace fiah;
+
+namespace
+{
+/// Every field equal, so a copy torn across two pushes is easy to spot
+struct Quote
+{
+    u64_t a, b, c;
+};
+
+Quote make_quote(u64_t i)
+{
+    return Quote{i, i, i};
+}
+} // namespace
+
+TEST(OverwriteRingTest, InOrderWhileTheConsumerKeepsUp)
+{
+    OverwriteRing<Quote, 8> ring;
+    Quote out{};
+    u64_t seq{};
+    EXPECT_FALSE(ring.pop(out));
+
+    for (u64_t i = 0; i < 20; ++i) // wraps twice
+    {
+        ring.push(make_quote(i));
+        if (i % 2)
+        {
+            for (u64_t j = i - 1; j <= i; ++j)
+            {
+                ASSERT_TRUE(ring.pop(out, seq));
+                EXPECT_EQ(seq, j);
+                EXPECT_EQ(out.a, j);
+            }
+        }
+    }
+    EXPECT_FALSE(ring.pop(out));
+    EXPECT_EQ(ring.pushed(), 20);
+    EXPECT_EQ(ring.lost(), 0);
+}
+
+TEST(OverwriteRingTest, LappedConsumerSkipsToTheOldestEntry)
+{
+    OverwriteRing<Quote, 8> ring;
+    Quote out{};
+    u64_t seq{};
+    ring.push(make_quote(0));
+    ASSERT_TRUE(ring.pop(out, seq));
+
+    // 1..20 pushed; only the last 8 (13..20) survive
+    for (u64_t i = 1; i <= 20; ++i)
+        ring.push(make_quote(i));
+
+    ASSERT_TRUE(ring.pop(out, seq));
+    EXPECT_EQ(seq, 13);
+    EXPECT_EQ(out.b, 13);
+    EXPECT_EQ(ring.lost(), 12);
+    for (u64_t i = 14; i <= 20; ++i)
+    {
+        ASSERT_TRUE(ring.pop(out, seq));
+        EXPECT_EQ(seq, i);
+    }
+    EXPECT_FALSE(ring.pop(out));
+    EXPECT_EQ(ring.next_seq(), 21);
+}
+
+TEST(OverwriteRingTest, ProducerNeverWaitsAndNothingIsTornOrCountedTwice)
+{
+    constexpr u64_t PUSHES{500'000};
+    auto ring = std::make_unique<OverwriteRing<Quote, 64>>();
+    std::atomic<bool> done{false};
+    u64_t received = 0;
+    u64_t bad = 0;
+
+    std::jthread consumer{[&] {
+        Quote out{};
+        u64_t seq{};
+        u64_t expected = 0;
+        auto drain = [&] {
+            while (ring->pop(out, seq))
+            {
+                // Gaps are exactly what lost() accounts for
+                bad += out.a != seq || out.b != seq || out.c != seq || seq < expected;
+                expected = seq + 1;
+                ++received;
+            }
+        };
+        while (!done.load(std::memory_order_acquire))
+            drain();
+        drain();
+    }};
+
+    for (u64_t i = 0; i < PUSHES; ++i)
+        ring->push(make_quote(i));
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    EXPECT_EQ(bad, 0);
+    EXPECT_EQ(received + ring->lost(), PUSHES);
+    EXPECT_EQ(ring->next_seq(), PUSHES);
+}
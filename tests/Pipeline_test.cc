@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "fiah/engine/Pipeline.hh"
+#include "fiah/io/Udp.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+
+using namespace fiah;
+
+namespace
+{
+/// Waits up to a second for `done()`; the stages run on their own threads.
+template <class Pred> bool eventually(Pred done)
+{
+    for (int i = 0; i < 1000 && !done(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    return done();
+}
+} // namespace
+
+TEST(PipelineTest, WireTradeCarriesEveryTradeFieldAndZeroedPadding)
+{
+    const Trade trade{7, 9, 9, false, -1234, 56};
+    const WireTrade msg = WireTrade::from(42, trade);
+    EXPECT_EQ(msg.origin_ns, 42);
+    const Trade back = msg.trade();
+    EXPECT_EQ(back.OrderIdA, 7);
+    EXPECT_EQ(back.OrderIdB, 9);
+    EXPECT_EQ(back.AggressorOrderId, 9);
+    EXPECT_FALSE(back.AggressorIsBuy);
+    EXPECT_EQ(back.Level, -1234);
+    EXPECT_EQ(back.Size, 56);
+    for (const u8_t b : msg.pad)
+        EXPECT_EQ(b, 0);
+}
+
+// Stages share whatever cores the test box has, so everything yields when idle
+TEST(PipelineTest, LoopbackRoundTripTimesEveryTrade)
+{
+    auto load = LoadGenerator::create(
+        {.rate = 20'000, .drain_timeout = std::chrono::milliseconds{100}, .yield_when_idle = true});
+    ASSERT_TRUE(load);
+    auto pipeline = MatchingPipeline<>::start(LadderOrderbook{256, 1024},
+                                              {.egress_port = load->listen_port(), .yield_when_idle = true});
+    ASSERT_TRUE(pipeline);
+
+    // Every buy takes out the sell just before it: one trade per pair
+    constexpr Id PAIRS{200};
+    std::vector<OrderEvent> events;
+    for (Id id = 1; id <= 2 * PAIRS; id += 2)
+    {
+        events.push_back(OrderEvent::add(0, Order{id, 100, false, 5}));
+        events.push_back(OrderEvent::add(0, Order{id + 1, 100, true, 5}));
+    }
+
+    const LoadReport report = load->run((*pipeline)->ingress_port(), events);
+    EXPECT_EQ(report.sent, events.size());
+    EXPECT_EQ(report.trades_received, PAIRS);
+    EXPECT_GT(report.p50_ns, 0);
+    EXPECT_LE(report.p50_ns, report.p99_ns);
+    EXPECT_LE(report.p99_ns, report.max_ns);
+
+    (*pipeline)->stop();
+    const PipelineStats stats = (*pipeline)->stats();
+    EXPECT_EQ(stats.received, events.size());
+    EXPECT_EQ(stats.applied, events.size());
+    EXPECT_EQ(stats.trades, PAIRS);
+    EXPECT_EQ(stats.sent, PAIRS);
+    EXPECT_EQ(stats.malformed + stats.ingress_drops + stats.egress_drops + stats.send_errors, 0);
+    EXPECT_EQ((*pipeline)->book().size(), 0);
+}
+
+TEST(PipelineTest, WrongSizedDatagramsAreCountedAndSkipped)
+{
+    auto pipeline = MatchingPipeline<>::start(LadderOrderbook{256, 1024}, {.yield_when_idle = true});
+    ASSERT_TRUE(pipeline);
+
+    UdpClient client{"127.0.0.1", (*pipeline)->ingress_port()};
+    const char junk[] = "not an order";
+    ASSERT_EQ(client.send(junk, sizeof(junk)), static_cast<ssize_t>(sizeof(junk)));
+    const WireOrder order{wire_clock_ns(), OrderEvent::add(0, Order{1, 100, true, 5})};
+    ASSERT_EQ(client.send(&order, sizeof(order)), static_cast<ssize_t>(sizeof(order)));
+
+    EXPECT_TRUE(eventually([&] { return (*pipeline)->stats().applied == 1; }));
+    (*pipeline)->stop();
+    EXPECT_EQ((*pipeline)->stats().malformed, 1);
+    EXPECT_EQ((*pipeline)->book().size(), 1);
+}
+
+TEST(PipelineTest, DatagramsWithBadFieldsAreCountedAndSkipped)
+{
+    auto pipeline = MatchingPipeline<>::start(LadderOrderbook{256, 1024}, {.yield_when_idle = true});
+    ASSERT_TRUE(pipeline);
+
+    UdpClient client{"127.0.0.1", (*pipeline)->ingress_port()};
+    WireOrder bad{wire_clock_ns(), OrderEvent::add(0, Order{1, 100, true, 5})};
+    auto *raw = reinterpret_cast<unsigned char *>(&bad);
+    raw[offsetof(WireOrder, event) + offsetof(OrderEvent, type)] = 0x7f;
+    ASSERT_EQ(client.send(&bad, sizeof(bad)), static_cast<ssize_t>(sizeof(bad)));
+    const WireOrder order{wire_clock_ns(), OrderEvent::add(0, Order{2, 100, true, 5})};
+    ASSERT_EQ(client.send(&order, sizeof(order)), static_cast<ssize_t>(sizeof(order)));
+
+    EXPECT_TRUE(eventually([&] { return (*pipeline)->stats().applied == 1; }));
+    (*pipeline)->stop();
+    EXPECT_EQ((*pipeline)->stats().malformed, 1);
+    EXPECT_EQ((*pipeline)->book().size(), 1);
+}
@@ -0,0 +1,71 @@
+// clang-format off
+#include "fiah/utils/Probe.hh"
+#include "fiah/structs/Orderbook.hh"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+// clang-format on
+
+using namespace fiah;
+
+TEST(LatencyHistogramTest, BucketsAreContiguousAndBounded)
+{
+    for (u64_t v = 0; v < 4096; ++v)
+    {
+        const sz_t b = LatencyHistogram::bucket_of(v);
+        EXPECT_LE(v, LatencyHistogram::bucket_upper(b)) << v;
+        if (b > 0)
+        {
+            EXPECT_GT(v, LatencyHistogram::bucket_upper(b - 1)) << v;
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_of(~u64_t{0}), LatencyHistogram::NUM_BUCKETS - 1);
+    EXPECT_EQ(LatencyHistogram::bucket_upper(LatencyHistogram::NUM_BUCKETS - 1), ~u64_t{0});
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketResolution)
+{
+    LatencyHistogram h;
+    EXPECT_EQ(h.percentile(0.5), 0);
+    for (u64_t v = 1; v <= 1000; ++v)
+        h.record(v);
+    EXPECT_EQ(h.count(), 1000);
+    EXPECT_EQ(h.sum(), 500'500);
+    EXPECT_EQ(h.max(), 1000);
+    EXPECT_GE(h.percentile(0.5), 500);
+    EXPECT_LE(h.percentile(0.5), 500 * 5 / 4);
+    EXPECT_GE(h.percentile(0.99), 990);
+    EXPECT_EQ(h.percentile(1.0), 1000);
+
+    const LatencyHistogram copy = h;
+    h.reset();
+    EXPECT_EQ(h.count(), 0);
+    EXPECT_EQ(copy.count(), 1000);
+}
+
+TEST(ProbedOrderbookTest, RecordsEachPhaseItPasses)
+{
+    ProbedOrderbook book;
+    (void)book.AddOrder(Order{1, 100, false, 5}); // rests
+    (void)book.AddOrder(Order{1, 100, false, 5}); // dupe
+    (void)book.AddOrder(Order{2, 100, true, 2});  // fills, nothing rests
+    (void)book.AddOrder(Order{3, 99, true, 2});   // rests
+
+    const auto &probe = book.probe();
+    EXPECT_EQ(probe.histogram(MatchPhase::DUPE_CHECK).count(), 4);
+    EXPECT_EQ(probe.histogram(MatchPhase::SWEEP).count(), 3);
+    EXPECT_EQ(probe.histogram(MatchPhase::LEVEL_SEARCH).count(), 2);
+    EXPECT_EQ(probe.histogram(MatchPhase::INSERT).count(), 2);
+
+    std::ostringstream out;
+    probe.dump(out, calibrate_tsc(std::chrono::milliseconds{1}));
+    EXPECT_NE(out.str().find("level_search"), std::string::npos);
+    EXPECT_NE(out.str().find("(ns)"), std::string::npos);
+}
+
+TEST(ProbedOrderbookTest, DisabledProbeTakesNoSpace)
+{
+    static_assert(sizeof(Orderbook) == sizeof(ProbedOrderbook) - sizeof(TscProbe<MatchPhase>));
+    static_assert(std::is_empty_v<NoProbe>);
+}
@@ -0,0 +1,110 @@
+// clang-format off
+#include "fiah/engine/RiskGate.hh"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <vector>
+
+#include "fiah/structs/Orderbook.hh"
+// clang-format on
+
+using namespace fiah;
+
+namespace
+{
+constexpr RiskLimits LIMITS{.max_order_qty = 100,
+                            .max_order_notional = 10'000,
+                            .max_position = 150,
+                            .max_orders_per_window = 3,
+                            .rate_window_ns = 1'000};
+} // namespace
+
+TEST(RiskGateTest, UnknownAndDisabledAccountsAreRejected)
+{
+    RiskGate gate{4};
+    EXPECT_EQ(gate.check(4, true, 1, 1, 0).error(), RiskError::UNKNOWN_ACCOUNT);
+    EXPECT_EQ(gate.check(0, true, 1, 1, 0).error(), RiskError::DISABLED); // no limits set yet
+    EXPECT_FALSE(gate.set_limits(4, LIMITS));
+
+    ASSERT_TRUE(gate.set_limits(0, LIMITS));
+    EXPECT_TRUE(gate.check(0, true, 1, 1, 0));
+    gate.set_enabled(0, false);
+    EXPECT_EQ(gate.check(0, true, 1, 1, 0).error(), RiskError::DISABLED);
+    EXPECT_EQ(gate.rejected(RiskError::DISABLED), 2);
+    EXPECT_EQ(gate.accepted(), 1);
+}
+
+TEST(RiskGateTest, SizeAndNotionalLimits)
+{
+    RiskGate gate{1};
+    gate.set_limits(0, LIMITS);
+    EXPECT_EQ(gate.check(0, true, 0, 10, 0).error(), RiskError::ORDER_QTY);
+    EXPECT_EQ(gate.check(0, true, 101, 10, 0).error(), RiskError::ORDER_QTY);
+    EXPECT_EQ(gate.check(0, false, 100, 101, 0).error(), RiskError::NOTIONAL);
+    EXPECT_TRUE(gate.check(0, false, 100, 100, 0));
+}
+
+TEST(RiskGateTest, NonPositivePriceAndNotionalOverflowAreRejected)
+{
+    RiskGate gate{1};
+    gate.set_limits(0, {.max_order_qty = 100});
+    EXPECT_EQ(gate.check(0, true, 10, 0, 0).error(), RiskError::PRICE);
+    EXPECT_EQ(gate.check(0, true, 10, -5, 0).error(), RiskError::PRICE);
+    // A market order's collar may be unset
+    EXPECT_TRUE(gate.check(0, Order{1, 0, true, 10, Order::Type::MARKET}, 0));
+
+    // With no notional limit, only the overflow can reject these
+    constexpr Quantity QTY{7};
+    constexpr Price FITS{std::numeric_limits<Price>::max() / QTY};
+    EXPECT_TRUE(gate.check(0, true, QTY, FITS, 0));
+    EXPECT_EQ(gate.check(0, true, QTY, FITS + 1, 0).error(), RiskError::NOTIONAL);
+    EXPECT_EQ(gate.check(0, true, 100, std::numeric_limits<Price>::max(), 0).error(), RiskError::NOTIONAL);
+}
+
+TEST(RiskGateTest, PositionIsWorstCaseAfterFullFill)
+{
+    RiskGate gate{1};
+    gate.set_limits(0, LIMITS);
+    gate.on_fill(0, true, 100);
+    EXPECT_EQ(gate.check(0, true, 51, 1, 0).error(), RiskError::POSITION);
+    EXPECT_TRUE(gate.check(0, true, 50, 1, 0));
+    // Selling reduces risk, down to -150
+    EXPECT_TRUE(gate.check(0, false, 100, 1, 0));
+    gate.on_fill(0, false, 100);
+    gate.on_fill(0, false, 100);
+    EXPECT_EQ(gate.account(0).position, -100);
+    EXPECT_EQ(gate.check(0, false, 51, 1, 0).error(), RiskError::POSITION);
+}
+
+TEST(RiskGateTest, RateWindowRolls)
+{
+    RiskGate gate{1};
+    gate.set_limits(0, LIMITS);
+    for (u64_t t = 0; t < 3; ++t)
+        EXPECT_TRUE(gate.check(0, true, 1, 1, 100 + t));
+    EXPECT_EQ(gate.check(0, true, 1, 1, 500).error(), RiskError::RATE);
+    // Rejected orders do not count; the window restarts once it has elapsed
+    EXPECT_TRUE(gate.check(0, true, 1, 1, 1'100));
+    EXPECT_EQ(gate.account(0).window_orders, 1);
+}
+
+TEST(RiskGateTest, AddOrderTracksAggressorFills)
+{
+    RiskGate gate{2};
+    gate.set_limits(0, LIMITS);
+    gate.set_limits(1, LIMITS);
+    Orderbook book;
+    std::vector<Trade> trades;
+    auto sink = [&trades](const Trade &trade) { trades.push_back(trade); };
+
+    ASSERT_TRUE(gate.add_order(book, 0, Order{1, 50, false, 30}, 0, sink));
+    ASSERT_TRUE(gate.add_order(book, 1, Order{2, 50, true, 20}, 0, sink));
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(gate.account(1).position, 20);
+    EXPECT_EQ(gate.account(0).position, 0); // resting side is the caller's to book
+
+    // A rejected order never reaches the book
+    EXPECT_EQ(gate.add_order(book, 1, Order{3, 50, true, 200}, 0, sink).error(), RiskError::ORDER_QTY);
+    EXPECT_FALSE(book.is_dupe(Order{3, 0, true, 0}));
+}
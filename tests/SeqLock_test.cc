@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "fiah/engine/Bbo.hh"
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/structs/SeqLock.hh"
+#include "fiah/structs/SoAOrderbook.hh"
+
+using namespace fiah;
+
+namespace
+{
+/// Every field equal, so a copy torn across two stores is easy to spot
+struct Quad
+{
+    u64_t a, b, c, d;
+};
+} // namespace
+
+TEST(SeqLockTest, StoreThenLoad)
+{
+    SeqLock<Quad> lock;
+    EXPECT_EQ(lock.version(), 0);
+    EXPECT_EQ(lock.load().a, 0);
+
+    lock.store(Quad{1, 2, 3, 4});
+    lock.store(Quad{5, 6, 7, 8});
+    const Quad q = lock.load();
+    EXPECT_EQ(q.a, 5);
+    EXPECT_EQ(q.d, 8);
+    EXPECT_EQ(lock.version(), 2);
+
+    Quad out{};
+    EXPECT_TRUE(lock.try_load(out));
+    EXPECT_EQ(out.b, 6);
+}
+
+TEST(SeqLockTest, ConcurrentReadersNeverSeeTornValues)
+{
+    constexpr u64_t STORES{200'000};
+    SeqLock<Quad> lock;
+    std::atomic<bool> done{false};
+    std::atomic<u64_t> torn{0};
+
+    std::vector<std::jthread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&] {
+            u64_t last = 0;
+            while (!done.load(std::memory_order_relaxed))
+            {
+                const Quad q = lock.load();
+                if (q.a != q.b || q.a != q.c || q.a != q.d || q.a < last)
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                last = q.a;
+            }
+        });
+    }
+
+    for (u64_t i = 1; i <= STORES; ++i)
+        lock.store(Quad{i, i, i, i});
+    done.store(true, std::memory_order_relaxed);
+    readers.clear();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(lock.load().a, STORES);
+}
+
+template <class Book> class BboPublisherTest : public ::testing::Test
+{
+  protected:
+    Book book{};
+};
+
+using BboBooks = ::testing::Types<Orderbook, LadderOrderbook, SoAOrderbook>;
+TYPED_TEST_SUITE(BboPublisherTest, BboBooks);
+
+TYPED_TEST(BboPublisherTest, RepublishesOnlyWhenTheTopChanges)
+{
+    BboPublisher bbo;
+    EXPECT_FALSE(bbo.update(this->book));
+    EXPECT_FALSE(bbo.read().has_bid());
+
+    (void)this->book.AddOrder(Order{1, 100, true, 5});
+    EXPECT_TRUE(bbo.update(this->book));
+    (void)this->book.AddOrder(Order{2, 105, false, 3});
+    EXPECT_TRUE(bbo.update(this->book));
+    EXPECT_EQ(bbo.version(), 2);
+
+    // Deeper levels do not move the top
+    (void)this->book.AddOrder(Order{3, 98, true, 9});
+    (void)this->book.AddOrder(Order{4, 110, false, 9});
+    EXPECT_FALSE(bbo.update(this->book));
+    EXPECT_EQ(bbo.version(), 2);
+
+    // Joining the best bid changes its size
+    (void)this->book.AddOrder(Order{5, 100, true, 2});
+    EXPECT_TRUE(bbo.update(this->book));
+    Bbo top = bbo.read();
+    EXPECT_EQ(top.bid_price, 100);
+    EXPECT_EQ(top.bid_qty, 7);
+    EXPECT_EQ(top.bid_count, 2);
+    EXPECT_EQ(top.ask_price, 105);
+    EXPECT_EQ(top.ask_qty, 3);
+
+    // Sweeping the ask exposes the next level
+    (void)this->book.AddOrder(Order{6, 105, true, 3});
+    EXPECT_TRUE(bbo.update(this->book));
+    ASSERT_TRUE(bbo.try_read(top));
+    EXPECT_EQ(top.ask_price, 110);
+    EXPECT_EQ(top.ask_qty, 9);
+}
@@ -0,0 +1,283 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include "fiah/structs/LadderOrderbook.hh"
+#include "fiah/structs/Orderbook.hh"
+#include "fiah/utils/XorBitant.hh"
+
+using namespace fiah;
+
+namespace
+{
+std::string temp_image_path(const char *name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::string read_file(const std::string &path)
+{
+    std::ifstream in{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+/// Overwrites the low `width` bytes of `value` at `offset` into the first
+/// record of the image at `path` that starts with `id`.
+bool patch_record(const std::string &path, Id id, long offset, i64_t value, std::size_t width)
+{
+    const std::string bytes = read_file(path);
+    const std::size_t at = bytes.find(std::string{reinterpret_cast<const char *>(&id), sizeof(id)});
+    std::FILE *f = std::fopen(path.c_str(), "r+b");
+    if (at == std::string::npos || !f)
+        return false;
+    std::fseek(f, static_cast<long>(at) + offset, SEEK_SET);
+    std::fwrite(&value, width, 1, f);
+    std::fclose(f);
+    return true;
+}
+
+struct Patch
+{
+    Id id;
+    long offset;
+    i64_t value;
+    std::size_t width;
+    const char *what;
+};
+
+/// Drives `a` and `b` with the same random flow and checks every trade matches.
+template <class BookA, class BookB> void expect_same_flow(BookA &a, BookB &b, u64_t seed, Id first_id, int steps)
+{
+    XorBitant rng{seed};
+    Id next_id = first_id;
+    for (int i = 0; i < steps; ++i)
+    {
+        Trades expected;
+        Trades actual;
+        if (rng() % 4 == 0)
+        {
+            const Id victim = 1 + rng() % (next_id - 1);
+            a.CancelOrder(victim);
+            b.CancelOrder(victim);
+            continue;
+        }
+        Order order{next_id++, 1000 + static_cast<Price>(rng() % 64), (rng() & 1) != 0,
+                    1 + static_cast<Quantity>(rng() % 20)};
+        expected = a.AddOrder(order);
+        actual = b.AddOrder(order);
+        ASSERT_EQ(expected.size(), actual.size()) << "step " << i;
+        for (std::size_t t = 0; t < expected.size(); ++t)
+        {
+            EXPECT_EQ(expected[t].OrderIdA, actual[t].OrderIdA);
+            EXPECT_EQ(expected[t].OrderIdB, actual[t].OrderIdB);
+            EXPECT_EQ(expected[t].Level, actual[t].Level);
+            EXPECT_EQ(expected[t].Size, actual[t].Size);
+        }
+    }
+}
+
+/// Checks the top levels of both sides agree, qty and count included.
+template <class BookA, class BookB> void expect_same_depth(const BookA &a, const BookB &b)
+{
+    for (const auto side : {OrderSide::BUY, OrderSide::SELL})
+    {
+        std::array<DepthLevel, 8> expected{};
+        std::array<DepthLevel, 8> actual{};
+        const auto n = a.top_levels(side, expected);
+        ASSERT_EQ(b.top_levels(side, actual), n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(actual[i].price, expected[i].price);
+            EXPECT_EQ(actual[i].qty, expected[i].qty);
+            EXPECT_EQ(actual[i].count, expected[i].count);
+        }
+    }
+}
+} // namespace
+
+template <class Book> class SnapshotTest : public ::testing::Test
+{
+};
+
+using SnapshotBooks = ::testing::Types<Orderbook, LadderOrderbook>;
+TYPED_TEST_SUITE(SnapshotTest, SnapshotBooks);
+
+TYPED_TEST(SnapshotTest, RestoredBookTradesLikeTheOriginal)
+{
+    const std::string path = temp_image_path("fiah_snapshot_roundtrip.img");
+    TypeParam original{};
+    TypeParam warmup{};
+    expect_same_flow(original, warmup, 7, 1, 5000);
+
+    ASSERT_TRUE(original.save_snapshot(path));
+    auto restored = TypeParam::restore_snapshot(path);
+    ASSERT_TRUE(restored);
+    std::remove(path.c_str());
+
+    // Queue priority, aggregates and the id index all have to survive for
+    // the two books to keep producing identical trades
+    expect_same_depth(original, *restored);
+    expect_same_flow(original, *restored, 8, 5001, 5000);
+    expect_same_depth(original, *restored);
+}
+
+TYPED_TEST(SnapshotTest, EmptyBookRoundTrips)
+{
+    const std::string path = temp_image_path("fiah_snapshot_empty.img");
+    TypeParam original{};
+    ASSERT_TRUE(original.save_snapshot(path));
+    auto restored = TypeParam::restore_snapshot(path);
+    ASSERT_TRUE(restored);
+    std::remove(path.c_str());
+
+    EXPECT_TRUE(restored->AddOrder(Order{1, 100, false, 5}).empty());
+    EXPECT_EQ(restored->AddOrder(Order{2, 100, true, 5}).size(), 1);
+}
+
+TYPED_TEST(SnapshotTest, RejectsForeignAndTruncatedImages)
+{
+    EXPECT_EQ(TypeParam::restore_snapshot(temp_image_path("fiah_snapshot_missing.img")).error(),
+              FileError::OPEN_FAIL);
+
+    const std::string path = temp_image_path("fiah_snapshot_bad.img");
+    TypeParam original{};
+    for (Id id = 1; id <= 100; ++id)
+        (void)original.AddOrder(Order{id, 900 + static_cast<Price>(id), false, 1});
+    ASSERT_TRUE(original.save_snapshot(path));
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+    EXPECT_EQ(TypeParam::restore_snapshot(path).error(), FileError::TRUNCATED);
+
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::fputs("this is not a book image, only a long enough line of text to fill a header", f);
+    std::fclose(f);
+    EXPECT_EQ(TypeParam::restore_snapshot(path).error(), FileError::BAD_HEADER);
+    std::remove(path.c_str());
+}
+
+TYPED_TEST(SnapshotTest, SameBookWritesTheSameBytes)
+{
+    const std::string first = temp_image_path("fiah_snapshot_bytes_a.img");
+    const std::string second = temp_image_path("fiah_snapshot_bytes_b.img");
+    // Two books built apart, so nothing but their contents is shared
+    for (const std::string &path : {first, second})
+    {
+        TypeParam book;
+        for (Id id = 1; id <= 40; ++id)
+            (void)book.AddOrder(Order{id, 1000 + static_cast<Price>(id % 9) * (id % 2 ? 1 : -1), id % 2 == 0,
+                                      static_cast<Quantity>(id)});
+        book.CancelOrder(7);
+        ASSERT_TRUE(book.save_snapshot(path, 11));
+    }
+    const std::string a = read_file(first);
+    EXPECT_FALSE(a.empty());
+    EXPECT_TRUE(a == read_file(second));
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+}
+
+TEST(OrderbookSnapshotTest, RejectsCorruptedOrders)
+{
+    const std::string path = temp_image_path("fiah_snapshot_corrupt_orders.img");
+    Orderbook original{};
+    (void)original.AddOrder(Order{0x5EED'0001, 1000, true, 5});
+    (void)original.AddOrder(Order{0x5EED'0002, 1010, true, 5});
+    (void)original.AddOrder(Order{0x5EED'0003, 1020, false, 5});
+
+    // Each record starts with its id; level, qty, is_buy and type follow at
+    // byte offsets 8, 16, 24 and 25
+    for (const Patch &patch : {Patch{0x5EED'0001, 24, 0, 1, "bid marked as a sell"},
+                               Patch{0x5EED'0003, 24, 1, 1, "ask marked as a buy"},
+                               Patch{0x5EED'0001, 25, 1, 1, "resting MARKET order"},
+                               Patch{0x5EED'0001, 25, 0x7F, 1, "type out of range"},
+                               Patch{0x5EED'0002, 16, 0, 8, "zero qty"},
+                               Patch{0x5EED'0002, 16, -5, 8, "negative qty"},
+                               Patch{0x5EED'0002, 16, i64_t{1} << 40, 8, "qty wider than Quantity"},
+                               Patch{0x5EED'0002, 8, 990, 8, "bids out of price order"},
+                               Patch{0x5EED'0003, 8, 1005, 8, "crossed book"},
+                               Patch{0x5EED'0002, 0, 0x5EED'0001, 8, "repeated id"}})
+    {
+        ASSERT_TRUE(original.save_snapshot(path));
+        ASSERT_TRUE(Orderbook::restore_snapshot(path));
+        ASSERT_TRUE(patch_record(path, patch.id, patch.offset, patch.value, patch.width)) << patch.what;
+        EXPECT_EQ(Orderbook::restore_snapshot(path).error(), FileError::BAD_RECORD) << patch.what;
+    }
+    std::remove(path.c_str());
+}
+
+TEST(LadderSnapshotTest, RejectsOversizedWindowOrPool)
+{
+    const std::string path = temp_image_path("fiah_snapshot_ladder_oversized.img");
+    LadderOrderbook original{256, 1000};
+    (void)original.AddOrder(Order{1, 50'000, true, 3});
+
+    // num_levels and max_orders sit at byte offsets 24 and 32 of the header
+    for (const auto &[offset, value] : {std::pair<long, u64_t>{24, u64_t{1} << 40}, {32, u64_t{1} << 40},
+                                       {24, LadderOrderbook::MAX_RESTORE_LEVELS * 2},
+                                       {32, LadderOrderbook::MAX_RESTORE_ORDERS + 1}})
+    {
+        ASSERT_TRUE(original.save_snapshot(path));
+        std::FILE *f = std::fopen(path.c_str(), "r+b");
+        ASSERT_NE(f, nullptr);
+        std::fseek(f, offset, SEEK_SET);
+        std::fwrite(&value, sizeof(value), 1, f);
+        std::fclose(f);
+        EXPECT_EQ(LadderOrderbook::restore_snapshot(path).error(), FileError::BAD_HEADER) << "offset " << offset;
+    }
+    std::remove(path.c_str());
+}
+
+TEST(LadderSnapshotTest, RejectsCorruptedOrders)
+{
+    const std::string path = temp_image_path("fiah_snapshot_ladder_corrupt.img");
+    LadderOrderbook original{256, 1000};
+    (void)original.AddOrder(Order{0x5EED'0001, 50'000, true, 5});
+    (void)original.AddOrder(Order{0x5EED'0002, 50'000, true, 5});
+    (void)original.AddOrder(Order{0x5EED'0003, 50'010, false, 5});
+
+    // Each node starts with its id; price, qty, prev, next and is_buy follow
+    // at byte offsets 8, 16, 20, 24 and 28
+    for (const Patch &patch : {Patch{0x5EED'0001, 28, 0, 1, "bid marked as a sell"},
+                               Patch{0x5EED'0003, 28, 1, 1, "ask marked as a buy"},
+                               Patch{0x5EED'0002, 16, 0, 4, "zero qty"},
+                               Patch{0x5EED'0002, 16, 6, 4, "qty disagrees with its level"},
+                               Patch{0x5EED'0002, 8, 50'001, 8, "price disagrees with its level"},
+                               Patch{0x5EED'0003, 8, 49'999, 8, "crossed book"},
+                               Patch{0x5EED'0003, 8, 1, 8, "price outside the window"},
+                               Patch{0x5EED'0001, 24, 0, 4, "queue link loops back"},
+                               Patch{0x5EED'0001, 24, 7, 4, "queue link out of range"},
+                               Patch{0x5EED'0002, 20, -1, 4, "prev link disagrees with the queue"},
+                               Patch{0x5EED'0002, 0, 0x5EED'0004, 8, "id missing from the index"}})
+    {
+        ASSERT_TRUE(original.save_snapshot(path));
+        ASSERT_TRUE(LadderOrderbook::restore_snapshot(path));
+        ASSERT_TRUE(patch_record(path, patch.id, patch.offset, patch.value, patch.width)) << patch.what;
+        EXPECT_EQ(LadderOrderbook::restore_snapshot(path).error(), FileError::BAD_RECORD) << patch.what;
+    }
+    std::remove(path.c_str());
+}
+
+TEST(LadderSnapshotTest, KeepsWindowAndCapacity)
+{
+    const std::string path = temp_image_path("fiah_snapshot_ladder.img");
+    LadderOrderbook original{256, 1000};
+    (void)original.AddOrder(Order{1, 50'000, true, 3});
+    (void)original.AddOrder(Order{2, 50'100, false, 4});
+    ASSERT_TRUE(original.save_snapshot(path));
+    auto restored = LadderOrderbook::restore_snapshot(path);
+    ASSERT_TRUE(restored);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(restored->num_levels(), 256);
+    EXPECT_EQ(restored->size(), 2);
+    EXPECT_EQ(restored->best_bid(), 50'000);
+    EXPECT_EQ(restored->best_ask(), 50'100);
+    EXPECT_TRUE(restored->is_dupe(Order{2, 0, false, 0}));
+}
@@ -4,7 +4,11 @@
 
 #include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <ranges>
+#include <string>
+#include <vector>
+#include <thread>
 
 #include "fiah/utils/Timer.hh" 
 #include "test_utils.hh" 
@@ -42,4 +46,142 @@ TEST_F(SPSCQueueTest, AddElements)
 
     // Size shouldn't change
     EXPECT_EQ(p_test_obj.size(), 1024);
-}
\ No newline at end of file
+}
+
+TEST_F(SPSCQueueTest, DrainThenRefillAfterFull)
+{
+    std::ranges::for_each(std::views::iota(0, 1024), [this](int i) { EXPECT_TRUE(p_test_obj.push(i)); });
+    EXPECT_FALSE(p_test_obj.push(-1));
+
+    // The producer only sees the freed slot once it looks at the consumer again
+    int out{};
+    EXPECT_TRUE(p_test_obj.pop(out));
+    EXPECT_EQ(out, 0);
+    EXPECT_TRUE(p_test_obj.push(1024));
+    EXPECT_FALSE(p_test_obj.push(-1));
+
+    for (int expected = 1; expected <= 1024; ++expected)
+    {
+        ASSERT_TRUE(p_test_obj.pop(out));
+        EXPECT_EQ(out, expected);
+    }
+    EXPECT_FALSE(p_test_obj.pop(out));
+}
+
+// A tiny ring keeps both sides hitting full/empty, so the cached indices are
+// refreshed constantly while the threads race
+TEST(SPSCQueueThreadedTest, TransfersInOrderAcrossWraparound)
+{
+    constexpr std::uint64_t N{200'000};
+    fiah::SPSCQueue<std::uint64_t, 8> queue;
+
+    // Stops on its own if the consumer bails out on a failed assertion
+    std::jthread producer{[&queue](std::stop_token st) {
+        for (std::uint64_t i = 0; i < N; ++i)
+            while (!queue.push(i))
+            {
+                if (st.stop_requested())
+                    return;
+                std::this_thread::yield();
+            }
+    }};
+
+    std::uint64_t next = 0;
+    std::uint64_t value{};
+    while (next < N)
+    {
+        if (!queue.pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(value, next);
+        ++next;
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(SPSCQueueTest, BulkPushPopWrapsAround)
+{
+    // Move head and tail to 1000 so the next batch straddles the wrap point
+    std::vector<int> batch(1100);
+    EXPECT_EQ(p_test_obj.push_bulk(std::span<const int>{batch}.first(1000)), 1000);
+    EXPECT_EQ(p_test_obj.pop_bulk(batch), 1000);
+
+    std::iota(batch.begin(), batch.end(), 0);
+    EXPECT_EQ(p_test_obj.push_bulk(std::span<const int>{batch}.first(100)), 100);
+    // Only 924 more fit
+    EXPECT_EQ(p_test_obj.push_bulk(std::span<const int>{batch}.subspan(100)), 924);
+    EXPECT_EQ(p_test_obj.push_bulk(batch), 0);
+
+    std::vector<int> out(2000, -1);
+    EXPECT_EQ(p_test_obj.pop_bulk(out), 1024);
+    EXPECT_TRUE(std::ranges::equal(std::span<const int>{out}.first(1024), std::span<const int>{batch}.first(1024)));
+    EXPECT_EQ(p_test_obj.pop_bulk(out), 0);
+}
+
+TEST(SPSCQueueBulkTest, NonTrivialElementsAreConstructedAndDestroyed)
+{
+    fiah::SPSCQueue<std::string, 8> queue;
+    const std::vector<std::string> words{"a-long-enough-string-to-allocate", "b", "c", "d", "e"};
+    std::vector<std::string> out(8);
+    for (int round = 0; round < 3; ++round) // wraps on the second round
+    {
+        EXPECT_EQ(queue.push_bulk(words), 5);
+        EXPECT_EQ(queue.pop_bulk(out), 5);
+        EXPECT_TRUE(std::ranges::equal(std::span<const std::string>{out}.first(5), words));
+    }
+    EXPECT_EQ(queue.push_bulk(words), 5); // left for the destructor
+}
+
+TEST_F(SPSCQueueTest, ReserveCommitFrontRelease)
+{
+    EXPECT_EQ(p_test_obj.front(), nullptr);
+    for (int i = 0; i < 1024; ++i)
+    {
+        int *slot = p_test_obj.try_reserve();
+        ASSERT_NE(slot, nullptr);
+        *slot = i;
+        p_test_obj.commit();
+    }
+    EXPECT_EQ(p_test_obj.try_reserve(), nullptr);
+
+    // Interleaves with pop() and push() on the same indices
+    int out{-1};
+    EXPECT_TRUE(p_test_obj.pop(out));
+    EXPECT_EQ(out, 0);
+    EXPECT_TRUE(p_test_obj.push(1024));
+    for (int i = 1; i <= 1024; ++i)
+    {
+        const int *front = p_test_obj.front();
+        ASSERT_NE(front, nullptr);
+        EXPECT_EQ(*front, i);
+        p_test_obj.release();
+    }
+    EXPECT_EQ(p_test_obj.front(), nullptr);
+    EXPECT_TRUE(p_test_obj.empty());
+}
+
+TEST(SPSCQueueZeroCopyTest, ReleaseDestroysTheElement)
+{
+    fiah::SPSCQueue<std::string, 4> queue;
+    for (int round = 0; round < 3; ++round) // wraps on the second round
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            std::string *slot = queue.try_reserve();
+            ASSERT_NE(slot, nullptr);
+            EXPECT_TRUE(slot->empty()); // constructed, not left over
+            slot->assign("a-long-enough-string-to-allocate-").append(std::to_string(i));
+            queue.commit();
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            ASSERT_NE(queue.front(), nullptr);
+            EXPECT_EQ(*queue.front(), "a-long-enough-string-to-allocate-" + std::to_string(i));
+            queue.release();
+        }
+    }
+    ASSERT_NE(queue.try_reserve(), nullptr);
+    queue.commit(); // left for the destructor
+}